@@ -32,6 +32,10 @@ public:
     [[nodiscard]] Bitboard getBitboard(const Piece& piece) const;
     Bitboard& operator[](const Piece piece){ return bitboards[piece]; }
 
+    // whole-board copy in/out, used to snapshot and restore positions
+    const std::array<Bitboard, PIECE_N>& getRawBoards() const{ return bitboards; }
+    void setRawBoards(const std::array<Bitboard, PIECE_N>& boards){ bitboards = boards; }
+
     std::optional<Piece> getPiece(int rank, int file) const;
     std::optional<Piece> getPiece(int square) const;
 
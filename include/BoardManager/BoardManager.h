@@ -5,14 +5,14 @@
 #ifndef BOARDMANAGER_H
 #define BOARDMANAGER_H
 
-#include <stack>
+#include <vector>
 
 #include "BitBoards.h"
 
 #include "BoardManager/Move.h"
+#include "BoardManager/Position.h"
 
 #include "Engine/Piece.h"
-#include "Engine/RepetitionTable.h"
 #include "Engine/ZobristHash.h"
 
 #include "MagicBitboards/MagicBitBoards.h"
@@ -22,11 +22,6 @@
 
 class BitBoards;
 
-struct BoardState {
-    int enPassantSquare = -1;
-    std::string castlingRights = "";
-};
-
 enum GameResult {
     WHITE_WINS = 1 << 0,
     BLACK_WINS = 1 << 1,
@@ -42,16 +37,22 @@ enum GameResult {
 class BoardManager {
 public:
 
-    BoardManager() = default;
-    explicit BoardManager(const Colours colour) : currentTurn(colour){}
+    // plies of history allocated up front - doubled if a game ever runs past it
+    static constexpr size_t INITIAL_PLY_CAPACITY = 512;
+
+    BoardManager(){ moveHistory.reserve(INITIAL_PLY_CAPACITY); }
+    explicit BoardManager(const Colours colour) : BoardManager(){ positions_[0].sideToMove = colour; }
 
     BitBoards* getBitboards(){ return &magicBitBoards.bitBoards; }
-    std::stack<Move>& getMoveHistory(){ return moveHistory; }
+    const std::vector<Move>& getMoveHistory() const{ return moveHistory; }
+    const Move& lastMove() const{ return moveHistory.back(); }
     MagicBitBoards* getMagicBitBoards(){ return &magicBitBoards; }
-    int getEnPassantSquare(){ return boardStateHistory.top().enPassantSquare; }
+    int getEnPassantSquare() const{ return position().enPassantSquare; }
+    int getHalfMoveClock() const{ return position().halfMoveClock; }
+    uint8_t getCastlingRights() const{ return position().castlingRights; }
     ZobristHash* getZobristHash(){ return &zobristHash_; }
-    Colours getCurrentTurn() const{ return currentTurn; }
-    void setCurrentTurn(const Colours current_turn){ currentTurn = current_turn; }
+    Colours getCurrentTurn() const{ return position().sideToMove; }
+    void setCurrentTurn(const Colours current_turn){ position().sideToMove = current_turn; }
 
     // move interface
     bool tryMove(Move& move);
@@ -61,23 +62,25 @@ public:
     void undoMove(const Move& move);
     void undoMove();
     void makeNullMove();
+    void undoNullMove();
 
     bool isGameOver();
     int getGameResult();
 
+    // pieces giving check to the side to move
+    Bitboard getCheckers();
+    bool isInCheck(){ return getCheckers() != 0ULL; }
+    bool hasAnyLegalMoves();
+    bool isCheckmate();
+    bool isStalemate();
+
+    bool isRepetition(int pliesFromRoot) const;
+    bool isFiftyMoveDraw() const;
 
-    void resetGame(){
-        setFullFen(Fen::FULL_STARTING_FEN);
-        while (!moveHistory.empty()) { moveHistory.pop(); }
-        repetitionTable_New_.clear();
-        while (!boardStateHistory.empty()) { boardStateHistory.pop(); }
-    }
 
-    void resetGame(const FenString& fen){
-        setFullFen(fen);
-        while (!moveHistory.empty()) { moveHistory.pop(); }
-        repetitionTable_New_.clear();
-    };
+    // setting a fen starts a fresh history, so these are the same thing
+    void resetGame(){ setFullFen(Fen::FULL_STARTING_FEN); }
+    void resetGame(const FenString& fen){ setFullFen(fen); }
 
     void setFullFen(const FenString& fen);
     std::string getFullFen();
@@ -90,20 +93,23 @@ private:
     void makeMove(Move& move);
 
     void swapTurns();
-    bool threefoldRepetition();
+    bool threefoldRepetition() const;
+
+    // snapshot the live board into the current ply and copy it forward to the next
+    Position& pushPosition();
+    void popPosition();
+
+    Position& position(){ return positions_[ply_]; }
+    const Position& position() const{ return positions_[ply_]; }
 
     // data
     BitBoards& bitboards(){ return magicBitBoards.bitBoards; }
-    std::stack<Move> moveHistory;
-    std::stack<BoardState> boardStateHistory;
-    RepetitionTable repetitionTable_New_;
-    bool repetitionFlag = false;
-    Colours currentTurn = WHITE;
+    std::vector<Move> moveHistory;
+    std::vector<Position> positions_ = std::vector<Position>(INITIAL_PLY_CAPACITY);
+    size_t ply_ = 0;
     ZobristHash zobristHash_;
 
     MagicBitBoards magicBitBoards;
-
-    bool checkMateFlag = false;
 };
 
 
@@ -0,0 +1,73 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#ifndef CHESS_POSITION_H
+#define CHESS_POSITION_H
+
+#include <array>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <type_traits>
+
+#include "Engine/Piece.h"
+#include "Utility/ChessUtility.h"
+
+enum CastlingRights : uint8_t {
+    WHITE_KINGSIDE = 1 << 0,
+    WHITE_QUEENSIDE = 1 << 1,
+    BLACK_KINGSIDE = 1 << 2,
+    BLACK_QUEENSIDE = 1 << 3,
+};
+
+constexpr uint8_t ALL_CASTLING_RIGHTS = WHITE_KINGSIDE | WHITE_QUEENSIDE | BLACK_KINGSIDE | BLACK_QUEENSIDE;
+
+// the "KQkq" field of a fen
+inline uint8_t castlingRightsFromFen(const std::string_view field){
+    uint8_t rights = 0;
+    for (const char c: field) {
+        switch (c) {
+            case 'K': rights |= WHITE_KINGSIDE;
+                break;
+            case 'Q': rights |= WHITE_QUEENSIDE;
+                break;
+            case 'k': rights |= BLACK_KINGSIDE;
+                break;
+            case 'q': rights |= BLACK_QUEENSIDE;
+                break;
+            default: break;
+        }
+    }
+    return rights;
+}
+
+inline std::string castlingRightsToFen(const uint8_t rights){
+    std::string field;
+    if (rights & WHITE_KINGSIDE) { field += 'K'; }
+    if (rights & WHITE_QUEENSIDE) { field += 'Q'; }
+    if (rights & BLACK_KINGSIDE) { field += 'k'; }
+    if (rights & BLACK_QUEENSIDE) { field += 'q'; }
+    return field.empty() ? "-" : field;
+}
+
+/*
+ * Everything needed to get back to a position, in one flat block. The board manager
+ * keeps one of these per ply: making a move copies the current one forward and edits
+ * the copy, undoing a move just steps back to the previous ply.
+ */
+struct Position {
+    std::array<Bitboard, PIECE_N> bitboards{};
+    uint64_t hash = 0;
+    int enPassantSquare = -1;
+    int halfMoveClock = 0;
+    int fullMoveNumber = 1;
+    int pliesFromNull = 0;
+    // a board set up without a fen is treated as a fresh game
+    uint8_t castlingRights = ALL_CASTLING_RIGHTS;
+    Colours sideToMove = WHITE;
+};
+
+static_assert(std::is_trivially_copyable_v<Position>, "Position is copied forward every ply");
+
+#endif //CHESS_POSITION_H
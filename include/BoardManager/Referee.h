@@ -21,12 +21,12 @@ enum BoardStatus {
 class Referee {
 public:
 
-    static bool moveIsLegal(Move& move, BitBoards& boardState, MagicBitBoards& mbb, const int enPassantSquare = -1);
+    static bool moveIsLegal(Move& move, BitBoards& boardState, MagicBitBoards& mbb, const int enPassantSquare = -1,
+                            uint8_t castlingRights = 0);
     static int checkBoardStatus(BitBoards& bitboards, MagicBitBoards& magicBitBoards,
                                 Colours colourToMove);
-    bool isStalemate();
-    static bool hasAnyLegalMoves(BitBoards& bitBoards, MagicBitBoards& magicBitBoards,
-                                 Colours colourToMove);
+    static bool isKingInCheck(BitBoards& bitboards, MagicBitBoards& magicBitBoards,
+                              Colours currentTurn);
 
 private:
 
@@ -35,7 +35,7 @@ private:
     static bool handleCapture(Move& move, const BitBoards& bitboards);
     static void handleEnPassant(Move& move);
     static bool validateMove(Move& move, const BitBoards& bitboards, MagicBitBoards& magicBitBoards,
-                             const int enPassantSquare);
+                             const int enPassantSquare, uint8_t castlingRights);
     static bool validatePromotion(const Move& move);
 
 
@@ -48,8 +48,5 @@ private:
                                        MagicBitBoards& magicBitBoards, Colours currentTurn);
     static bool canPieceEscapeCheck(const Piece& pieceName, BitBoards& bitboards, MagicBitBoards& magicBitBoards,
                                     Colours currentTurn);
-
-    static bool isKingInCheck(BitBoards& bitboards, MagicBitBoards& magicBitBoards,
-                              Colours currentTurn);
 };
 #endif //CHESS_REFEREE_H
\ No newline at end of file
@@ -5,15 +5,23 @@
 #ifndef ENGINEBASE_H
 #define ENGINEBASE_H
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
 #include <filesystem>
 #include <fstream>
-#include <random>
+#include <functional>
+#include <mutex>
+#include <thread>
 
+#include "Bench.h"
 #include "ChessPlayer.h"
 #include "Evaluation.h"
 #include "PerftResults.h"
 #include "SearchHelpers.h"
+#include "TimeManager.h"
 #include "TranspositionTable.h"
+#include "UciWriter.h"
 
 #include "BoardManager/BoardManager.h"
 
@@ -23,28 +31,45 @@ public:
 
     // Constructor
     explicit ChessEngine();
+    ~ChessEngine() override;
 
     // Core Engine Interface
     SearchResults Search(int depth = 5);
     SearchResults Search(int MaxDepth, int SearchMs);
+    SearchResults SearchNodes(int MaxDepth, uint64_t nodeBudget);
+    SearchResults Search(const SearchLimits& limits);
     virtual std::vector<Move> generateMoveList();
 
     virtual bool sendCommand(const std::string& command) override;
     virtual std::string readResponse() override;
 
-    // control flags
-    void stop(){ shouldQuit_ = true; }
-    void quit(){ shouldQuit_ = true; }
+    // control flags - safe to call from the input thread while a search is running
+    void stop();
+    void quit();
+    void ponderHit();
 
     void reset(){
         internalBoardManager_.resetGame();
         lastSearchEvaluations.reset();
+        rootMoves_.clear();
         transpositionTable_.clear();
+        positionFen_.clear();
+        positionMoves_.clear();
     }
 
-    void go(int depth);
-    void go(int depth, int wtime, int btime, int winc = 0, int binc = 0);
+    // UCI "position" - when it continues the game we already have, only the new moves are played
+    void setPosition(const std::string& fen, const std::vector<std::string>& moves);
+
+    // go commands search on a worker thread and report "bestmove" when done
+    void go(const SearchLimits& limits);
     bool shouldQuit() const{ return shouldQuit_; }
+    // false as soon as bestmove is out, even before the search thread has been joined
+    bool isSearching() const{ return searching_; }
+
+    // sent and flushed straight away - serialised so the search and input threads don't interleave lines
+    void respond(const std::string& message);
+    // nothing is written to stdout while muted - no info lines, no bestmove
+    void setOutputMuted(const bool muted){ uciWriter_.setMuted(muted); }
 
     // Board State Management
     [[nodiscard]] BoardManager* boardManager(){ return &internalBoardManager_; }
@@ -54,8 +79,14 @@ public:
     virtual int getSearchDepth() const{ return searchDepth_; }
     virtual void setSearchDepth(const int search_depth){ searchDepth_ = search_depth; }
     MoveEvaluations& getLastSearchEvaluations(){ return lastSearchEvaluations; }
+    // number of best lines reported per search, 1 for normal play
+    static constexpr int MAX_MULTI_PV = 64;
+    int getMultiPV() const{ return multiPV_; }
+    void setMultiPV(const int multiPV){ multiPV_ = std::clamp(multiPV, 1, MAX_MULTI_PV); }
+    const std::vector<RootMove>& getRootMoves() const{ return rootMoves_; }
     TranspositionTable& getTranspositionTable(){ return transpositionTable_; }
     Evaluator* getEvaluator(){ return &evaluator_; }
+    PruningMargins& getPruningMargins(){ return pruningMargins_; }
 
     // UCI Protocol Interface
     virtual void parseUCI(const std::string& uci);
@@ -65,49 +96,95 @@ public:
     virtual PerftResults runPerftTest(const std::string& Fen, int depth);
     virtual std::vector<PerftResults> runDivideTest(const std::string& Fen, int depth);
     virtual std::vector<PerftResults> runDivideTest(int depth);
+    // splits the tree splitDepth plies down and counts the subtrees on `threads` workers
+    PerftResults runParallelPerftTest(const std::string& Fen, int depth, int threads, int splitDepth = 2);
+
 
+    // searches every bench position to depth from a fresh table and prints the node signature and nps
+    BenchResult bench(int depth = Bench::DEFAULT_DEPTH);
 
-    void logError(const std::string& error){ searchLogStream << error << std::endl; }
+    // the log is only created once there's something to put in it
+    void logError(const std::string& error);
 
 protected:
 
     // Performance Testing Implementation
     virtual PerftResults perft(int depth);
-    virtual int simplePerft(int depth);
+    virtual int64_t simplePerft(int depth);
     virtual std::vector<PerftResults> perftDivide(int depth);
 
     // Internal State
     BoardManager internalBoardManager_;
     Evaluator evaluator_{};
-    bool shouldQuit_ = false;
+    std::atomic<bool> shouldQuit_ = false;
     TranspositionTable transpositionTable_;
 
 private:
 
     int searchDepth_ = 4;
+    int multiPV_ = 1;
 
-    std::mt19937 rng;
     std::ofstream searchLogStream;
+    // numbers the log files per engine, so runs name them the same way every time
+    int instanceID_ = 0;
 
     std::chrono::steady_clock::time_point deadline;
 
-    SearchResults executeSearch(int depth, bool timed = false);
-    float alphaBeta(int depth, float alpha, float beta, int ply, std::vector<Move>& pv, bool timed = false,
-                    bool nullMoveAllowed = false);
-
-
-    std::optional<float> evaluateGameState(int depth, int ply, int boardStatus);
+    // how many nodes pass between reads of the shared stop flag and the clock
+    static constexpr int STOP_POLL_INTERVAL = 1024;
+    uint64_t nodeLimit_ = 0; // 0 means no node budget
+    uint64_t searchNodes_ = 0; // every alphaBeta and quiescence entry, the "nodes" the GUI is told about
+    std::chrono::steady_clock::time_point searchStart_;
+    // root "currmove" lines are only worth sending once a search has run this long
+    static constexpr int CURRMOVE_REPORT_DELAY_MS = 1000;
+
+    std::thread searchThread_;
+    std::atomic<bool> stopSearch_ = false;
+    std::atomic<bool> searching_ = false;
+    std::atomic<bool> pondering_ = false;
+    bool ponderingSearch_ = false; // search thread's view of pondering_, so it notices the switch
+    std::mutex searchStateMutex_;
+    std::condition_variable searchStateChanged_;
+    bool searchAborted_ = false; // only touched by the searching thread
+    int nodesSincePoll_ = 0;
+    TimeManager timeManager_;
+    UciWriter uciWriter_;
+
+    // the last position command, so the next one can be applied as a diff
+    std::string positionFen_;
+    std::vector<std::string> positionMoves_;
+    uint64_t positionHash_ = 0;
+
+    void startSearch(std::function<SearchResults()> search, bool waitForStop = false);
+    void reportBestMove(const SearchResults& result);
+    void beginSearch(std::chrono::steady_clock::time_point searchDeadline, uint64_t nodeLimit = 0);
+    bool pollStop();
+    void checkPonderHit();
+    SearchResults iterativeDeepening(int maxDepth);
+    void reportLines(int depth);
+    std::string infoLine(int depth, size_t pvIndex, const RootMove& rootMove);
+    int elapsedSearchMs() const;
+
+    void initialiseRootMoves();
+    SearchResults executeSearch(int depth);
+    float alphaBeta(int depth, float alpha, float beta, int ply, bool nullMoveAllowed = false);
+
+    float quiescence(float alpha, float beta, int ply);
+    bool performStaticPruning(int depth, float alpha, float beta, int ply, float staticEval,
+                              float& evaluatedValue);
     void SortMoves(std::vector<Move>& moves, const Move& ttMove);
-    bool performNullMoveReduction(int depth, float beta, int ply, bool timed,
-                                  float& evaluatedValue);
-    bool getTranspositionTableValue(int depth, Move& ttMove, float& evalResult);
-    void storeTranspositionTableEntry(int depth, float bestScore, Move bestMove);
+    bool performNullMoveReduction(int depth, float beta, int ply, float& evaluatedValue);
+    bool getTranspositionTableValue(int depth, float alpha, float beta, Move& ttMove, float& evalResult);
+    void storeTranspositionTableEntry(int depth, float bestScore, Move bestMove, TTBound bound);
     float performSearchLoop(std::vector<Move>& moves, const int depth, float alpha, const float beta,
-                            const int ply, const bool timed, std::vector<Move>& pv
+                            const int ply, bool futilityPruning = false
     );
 
     SearchStatistics currentSearchStats;
+    PruningMargins pruningMargins_;
+    PVTable pvTable_;
     MoveEvaluations lastSearchEvaluations;
+    std::vector<RootMove> rootMoves_;
 };
 
 
@@ -26,6 +26,10 @@ public:
 
     virtual bool sendCommand(const std::string& command) = 0;
     virtual std::string readResponse() = 0;
+    // readResponse, but allowed to wait up to timeoutMs for something to arrive rather than handing back nothing
+    virtual std::string waitForResponse(int timeoutMs);
+    // true once nothing more can ever be read, e.g. the engine process has exited
+    virtual bool outputClosed(){ return false; }
 
 
     PlayerType playerType;
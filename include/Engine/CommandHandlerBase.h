@@ -17,6 +17,7 @@ public:
     virtual void operator()(const UCICommand& cmd, ChessEngine* engine);
     virtual void operator()(const StopCommand& cmd, ChessEngine* engine);
     void operator()(const IsReadyCommand& cmd, ChessEngine* engine);
+    virtual void operator()(const PonderHitCommand& cmd, ChessEngine* engine);
     virtual void operator()(const QuitCommand& cmd, ChessEngine* engine);
     virtual void operator()(const GoCommand& cmd, ChessEngine* engine);
     virtual void operator()(const PositionCommand& cmd, ChessEngine* engine);
@@ -24,6 +25,8 @@ public:
     virtual void operator()(const NewGameCommand& cmd, ChessEngine* engine);
     void operator()(const IDCommand& cmd, ChessEngine* engine);
     void operator()(const SetIDCommand& cmd, ChessEngine* engine);
+    virtual void operator()(const SetOptionCommand& cmd, ChessEngine* engine);
+    virtual void operator()(const BenchCommand& cmd, ChessEngine* engine);
 };
 
 
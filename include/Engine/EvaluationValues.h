@@ -81,6 +81,7 @@ constexpr std::array zeroScores = {
 
 
 inline const float MATE_SCORE = 10000;
+inline const int MAX_SEARCH_PLY = 64; // scores within this many plies of MATE_SCORE are mate scores
 
 constexpr std::array<float, PIECE_N> pieceScoresArray = {
             1000, 310, 320, 500, 900, 1000,
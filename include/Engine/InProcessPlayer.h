@@ -0,0 +1,39 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#ifndef CHESS_INPROCESSPLAYER_H
+#define CHESS_INPROCESSPLAYER_H
+
+#include <memory>
+
+#include "ChessEngine.h"
+
+/*
+ * Plays a ChessEngine directly, for self-play inside one process. Moves go in as Move objects and the
+ * clock goes straight into SearchLimits, so there's no UCI text, no parsing and no position replay.
+ * The engine keeps its board and TT from one move to the next, and only a new game clears them.
+ *
+ * search() runs on the caller's thread - MatchRunner already gives every game a pool worker, and
+ * the side not to move has nothing to do in the meantime.
+ */
+class InProcessPlayer {
+public:
+
+    explicit InProcessPlayer(std::unique_ptr<ChessEngine> engine = std::make_unique<ChessEngine>());
+
+    // what ucinewgame and a position command would do
+    void newGame(const FenString& fen);
+    // either side's move - it must be legal in the current position
+    void play(const Move& move);
+
+    SearchResults search(const SearchLimits& limits){ return engine_->Search(limits); }
+
+    ChessEngine& engine(){ return *engine_; }
+
+private:
+
+    std::unique_ptr<ChessEngine> engine_;
+};
+
+#endif //CHESS_INPROCESSPLAYER_H
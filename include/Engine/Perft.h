@@ -0,0 +1,47 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#ifndef CHESS_PERFT_H
+#define CHESS_PERFT_H
+
+#include <cstdint>
+#include <vector>
+
+#include "BoardManager/BoardManager.h"
+#include "Engine/PerftCache.h"
+#include "Engine/PerftResults.h"
+
+class Perft {
+public:
+
+    // full breakdown (captures, checks, ...) of the leaves at depth
+    static PerftResults run(BoardManager& manager, int depth);
+    // one result per root move, with the move in fen
+    static std::vector<PerftResults> divide(BoardManager& manager, int depth);
+    // leaf count only, reusing subtree counts from cache when one's given
+    static int64_t count(BoardManager& manager, int depth, PerftCache* cache = nullptr);
+
+    /*
+     * Splits the tree splitDepth plies down into independent subtrees and runs them on a
+     * work-stealing pool. Each worker owns a copy of the board, replays a subtree's path onto
+     * it, counts it, then unwinds back to the root, so no board state is shared between threads.
+     */
+    static PerftResults parallel(const BoardManager& manager, int depth, int threads, int splitDepth = 2);
+    // as above for the leaf count only - every worker shares the one cache
+    static int64_t parallelCount(const BoardManager& manager, int depth, int threads, PerftCache* cache = nullptr,
+                                 int splitDepth = 2);
+
+private:
+
+    // runs count(board, remainingDepth) for every subtree and returns the results in subtree order
+    template<typename Result, typename Count>
+    static std::vector<Result> runSubtrees(const BoardManager& manager, int depth, int threads, int splitDepth,
+                                           Count countSubtree);
+
+    static void tallyLeaf(const Move& move, PerftResults& result);
+    static void collectSubtrees(BoardManager& manager, int plies, std::vector<Move>& path,
+                                std::vector<std::vector<Move> >& subtrees);
+};
+
+#endif //CHESS_PERFT_H
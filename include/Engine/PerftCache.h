@@ -0,0 +1,46 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#ifndef CHESS_PERFTCACHE_H
+#define CHESS_PERFTCACHE_H
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <optional>
+
+/*
+ * (zobrist, depth) -> node count, shared between perft threads without locks. Each slot
+ * holds the packed count/depth word and the key xor'd with it; a torn write from two
+ * threads storing at once leaves the pair inconsistent, so it just reads as a miss.
+ */
+class PerftCache {
+public:
+
+    explicit PerftCache(size_t sizeInMB = 64);
+
+    std::optional<int64_t> probe(uint64_t key, int depth) const;
+    // always replaces - perft revisits the same depths too evenly for a depth preference to pay
+    void store(uint64_t key, int depth, int64_t nodes);
+
+    size_t entries() const{ return mask_ + 1; }
+    void clear();
+
+private:
+
+    struct Entry {
+        std::atomic<uint64_t> check = 0;
+        std::atomic<uint64_t> data = 0;
+    };
+
+    // low byte depth, the rest the node count
+    static uint64_t pack(const int depth, const int64_t nodes){
+        return static_cast<uint64_t>(nodes) << 8 | static_cast<uint8_t>(depth);
+    }
+
+    std::unique_ptr<Entry[]> table_;
+    size_t mask_ = 0;
+};
+
+#endif //CHESS_PERFTCACHE_H
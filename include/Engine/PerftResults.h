@@ -4,16 +4,17 @@
 
 #ifndef PERFTRESULTS_H
 #define PERFTRESULTS_H
+#include <cstdint>
 #include <string>
 
 struct PerftResults {
-    int nodes = 0;
-    int captures = 0;
-    int enPassant = 0;
-    int castling = 0;
-    int checks = 0;
-    int checkMate = 0;
-    int promotions = 0;
+    int64_t nodes = 0;
+    int64_t captures = 0;
+    int64_t enPassant = 0;
+    int64_t castling = 0;
+    int64_t checks = 0;
+    int64_t checkMate = 0;
+    int64_t promotions = 0;
 
 
     std::string fen = "";
@@ -6,17 +6,34 @@
 #define CHESS_PROCESSCHESSENGINE_H
 #include <filesystem>
 #include <iostream>
+#include <optional>
 
 #include "ChessPlayer.h"
+#ifdef _WIN32
 #include <windows.h>
+#else
+#include <sys/types.h>
+#endif
 #include <fstream>
 
 class ProcessChessEngine final : public ChessPlayer {
 private:
 
+#ifdef _WIN32
     HANDLE hChildStdInWrite;
     HANDLE hChildStdOutRead;
     PROCESS_INFORMATION processInfo;
+#else
+    pid_t pid_ = -1;
+    int stdinFd_ = -1;
+    int stdoutFd_ = -1;
+    // output read from the pipe but not yet handed out - may end part way through a line
+    std::string pending_;
+    // how long readResponse waits for a complete line before giving up
+    int readTimeoutMs_ = 10;
+    // how long a command can sit waiting for room in the engine's stdin before the engine is killed
+    int writeTimeoutMs_ = 1000;
+#endif
     std::string enginePath;
 
 public:
@@ -36,10 +53,39 @@ public:
 
     virtual void setEngineID(const std::string& engineID) override;
 
+#ifndef _WIN32
+    /*
+     * Both pipes are non-blocking, so nothing here ever waits longer than it's told to. readResponse
+     * hands back only whole lines, and an engine that doesn't answer a request in time, or stops reading
+     * its input, is killed.
+     */
+    std::string waitForResponse(int timeoutMs) override;
+    // the pipe has hit EOF and every whole line has been handed out
+    bool outputClosed() override{ return stdoutFd_ < 0 && !hasLine(); }
+
+    // the engine's stdout, for polling alongside other engines - see ProcessPoller
+    int outputFd() const{ return stdoutFd_; }
+    bool isRunning();
+
+    // read whatever the pipe has without waiting - false once the engine has closed its end
+    bool pumpOutput();
+    bool hasLine() const{ return pending_.find('\n') != std::string::npos; }
+    std::optional<std::string> takeLine();
+    std::optional<std::string> readLine(int timeoutMs);
+
+    // send a command and wait for the line starting with replyPrefix, killing the engine if it doesn't come
+    std::optional<std::string> request(const std::string& command, const std::string& replyPrefix, int timeoutMs);
+
+    void setReadTimeout(const int timeoutMs){ readTimeoutMs_ = timeoutMs; }
+    void setWriteTimeout(const int timeoutMs){ writeTimeoutMs_ = timeoutMs; }
+    // SIGKILL and reap, for engines that won't quit
+    void kill();
+#endif
+
     std::filesystem::path path;
     std::string pathSuffix = "";
     std::ofstream outStream;
 };
 
 
-#endif //CHESS_PROCESSCHESSENGINE_H
\ No newline at end of file
+#endif //CHESS_PROCESSCHESSENGINE_H
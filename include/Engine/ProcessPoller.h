@@ -0,0 +1,38 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#ifndef CHESS_PROCESSPOLLER_H
+#define CHESS_PROCESSPOLLER_H
+
+#ifndef _WIN32
+
+#include <cstddef>
+#include <vector>
+
+class ProcessChessEngine;
+
+/*
+ * Waits on the output of many engine processes from one thread. Everything that has arrived is read
+ * into each engine's own line buffer, and the engines with a whole line ready are handed back.
+ * MatchRunner doesn't use it - a game only ever waits on the side to move, which waitForResponse
+ * already does in poll - it's for a single thread driving several engines at once.
+ */
+class ProcessPoller {
+public:
+
+    void add(ProcessChessEngine* engine);
+    void remove(ProcessChessEngine* engine);
+    std::size_t size() const{ return engines_.size(); }
+
+    // empty if nothing turned up in time - an engine whose output has closed stops being polled
+    std::vector<ProcessChessEngine*> wait(int timeoutMs);
+
+private:
+
+    std::vector<ProcessChessEngine*> engines_;
+};
+
+#endif
+
+#endif //CHESS_PROCESSPOLLER_H
@@ -2,17 +2,22 @@
 // Created by jacks on 15/10/2025.
 //
 
+#include <array>
 #include <cmath>
+#include <cstring>
 #include <iostream>
+#include <type_traits>
 #include <vector>
 
 #include "BoardManager/Move.h"
+#include "Engine/EvaluationValues.h"
 inline float percentOf(int numerator, int denominator){ return denominator > 0 ? 100.f * numerator / denominator : 0; }
 
 struct SearchStatistics {
     int searchID = 0;
     int nodesSearched = 0;
     int depth = 0;
+    int selDepth = 0; // deepest ply reached in the current iteration, quiescence included
 
     int endGameExits = 0;
     int nullMoveCutoffs = 0;
@@ -28,6 +33,11 @@ struct SearchStatistics {
 
     int pvHashHits = 0;
 
+    int reverseFutilityPrunes = 0;
+    int futilityPrunes = 0;
+    int razorPrunes = 0;
+    int quiescenceNodes = 0;
+
 
     void print() const{
         double ebf = std::pow(nodesSearched, 1.0 / depth);
@@ -47,7 +57,12 @@ struct SearchStatistics {
                 std::endl
 
                 << "tt hits: " << ttHits << " " << percentOf(ttHits, ttProbes) << std::endl
-                << "tt stores: " << ttStores
+                << "tt stores: " << ttStores << std::endl
+
+                << "Reverse futility prunes: " << reverseFutilityPrunes << std::endl
+                << "Futility prunes: " << futilityPrunes << std::endl
+                << "Razor prunes: " << razorPrunes << std::endl
+                << "Quiescence nodes: " << quiescenceNodes
                 << std::endl;
     }
 
@@ -55,6 +70,53 @@ struct SearchStatistics {
     float cutoffPercent() const{ return betaCutoffs > 0 ? 100.f * betaCutoffs / nodesSearched : 0; }
 };
 
+// static eval margins for the near-leaf pruning, in the same centipawn scale as Evaluator::evaluate().
+// indexed by remaining depth, so index 0 is unused
+struct PruningMargins {
+    static constexpr int MAX_PRUNING_DEPTH = 3;
+
+    bool enabled = true;
+    std::array<float, MAX_PRUNING_DEPTH + 1> reverseFutility{0, 120, 240, 360};
+    std::array<float, MAX_PRUNING_DEPTH + 1> futility{0, 100, 200, 300};
+    std::array<float, MAX_PRUNING_DEPTH + 1> razoring{0, 300, 450, 600};
+};
+
+static_assert(std::is_trivially_copyable_v<Move>, "PVTable copies moves with memcpy");
+
+// triangular principal variation table - row n holds the best line found from ply n downwards.
+// allocated once, so updating a line is a bounded memcpy of the child's row rather than a vector copy
+class PVTable {
+public:
+
+    PVTable() : moves(MAX_SEARCH_PLY * MAX_SEARCH_PLY), lengths(MAX_SEARCH_PLY, 0){}
+
+    void clear(const int ply){ lengths[ply] = 0; }
+
+    // move becomes the head of this ply's line, followed by whatever the child ply found
+    void update(const int ply, const Move& move){
+        Move* line = row(ply);
+        line[0] = move;
+
+        const int childLength = ply + 1 < MAX_SEARCH_PLY ? lengths[ply + 1] : 0;
+        if (childLength > 0) { std::memcpy(line + 1, row(ply + 1), childLength * sizeof(Move)); }
+        lengths[ply] = childLength + 1;
+    }
+
+    int length(const int ply) const{ return lengths[ply]; }
+
+    std::vector<Move> line(const int ply) const{
+        const Move* start = moves.data() + ply * MAX_SEARCH_PLY;
+        return {start, start + lengths[ply]};
+    }
+
+private:
+
+    Move* row(const int ply){ return moves.data() + ply * MAX_SEARCH_PLY; }
+
+    std::vector<Move> moves;
+    std::vector<int> lengths;
+};
+
 struct SearchResults {
     float score;
     Move bestMove;
@@ -63,6 +125,15 @@ struct SearchResults {
     SearchStatistics stats;
 };
 
+// a move at the root of the search, kept across iterative deepening iterations
+struct RootMove {
+    Move move;
+    float score = -MATE_SCORE - 1;
+    float previousScore = -MATE_SCORE - 1;
+    std::vector<Move> pv;
+    uint64_t nodes = 0;
+};
+
 struct MoveEvaluations {
     std::vector<Move> moves;
     std::vector<float> scores;
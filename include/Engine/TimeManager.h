@@ -0,0 +1,73 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#ifndef CHESS_TIMEMANAGER_H
+#define CHESS_TIMEMANAGER_H
+
+#include <chrono>
+#include <cstdint>
+#include <optional>
+
+#include "Engine/Piece.h"
+
+// everything a UCI "go" can ask for - unset fields mean "no limit of that kind"
+struct SearchLimits {
+    std::optional<int> depth;
+    std::optional<int> wtime;
+    std::optional<int> btime;
+    std::optional<int> winc;
+    std::optional<int> binc;
+    std::optional<int> movestogo;
+    std::optional<int> movetime;
+    std::optional<uint64_t> nodes;
+    bool infinite = false;
+    bool ponder = false;
+
+    bool hasClock() const{ return wtime.has_value() || btime.has_value(); }
+};
+
+/*
+ * Splits the clock into an optimum (soft) and maximum (hard) time for one move.
+ * The hard limit becomes the search deadline; the soft limit is checked between
+ * iterations and stretched or shrunk by how settled the search looks.
+ */
+class TimeManager {
+public:
+
+    // time kept back for GUI / pipe latency
+    static constexpr int MOVE_OVERHEAD_MS = 30;
+    // assumed moves left when the GUI doesn't send movestogo
+    static constexpr int DEFAULT_MOVES_TO_GO = 30;
+
+    void init(const SearchLimits& limits, Colours sideToMove);
+    // the clock only starts counting for real once a ponder search is confirmed
+    void restart(){ start_ = std::chrono::steady_clock::now(); }
+
+    bool isTimed() const{ return timed_; }
+    int optimumMs() const{ return optimumMs_; }
+    int maximumMs() const{ return maximumMs_; }
+
+    std::chrono::steady_clock::time_point hardDeadline() const;
+    int elapsedMs() const;
+
+    // feed the result of each completed iteration in
+    void updateIteration(bool bestMoveChanged, float score, uint64_t bestMoveNodes, uint64_t totalNodes);
+
+    // checked between iterations - true when another iteration isn't worth starting
+    bool shouldStop() const;
+
+private:
+
+    bool timed_ = false;
+    int optimumMs_ = 0;
+    int maximumMs_ = 0;
+    std::chrono::steady_clock::time_point start_;
+
+    // soft limit scaling, recomputed after every iteration
+    float bestMoveInstability_ = 0.0f;
+    float scale_ = 1.0f;
+    std::optional<float> previousScore_;
+};
+
+#endif //CHESS_TIMEMANAGER_H
@@ -7,12 +7,20 @@
 #include "BoardManager/BoardManager.h"
 
 
+// what the stored eval means relative to the window it was searched with
+enum class TTBound : uint8_t {
+    EXACT, // inside the window
+    LOWER, // failed high - the real score is at least this
+    UPPER, // failed low - the real score is at most this
+};
+
 struct TTEntry {
     uint64_t key;
     float eval;
     Move bestMove;
     int depth;
     int age;
+    TTBound bound = TTBound::EXACT;
 };
 
 struct TTStats {
@@ -39,6 +47,8 @@ public:
     size_t size() const{ return vectorTable.size() * sizeof(TTEntry); }
     size_t entries() const{ return vectorTable.size(); }
     size_t populatedEntries() const;
+    // UCI hashfull - permille of the table in use, estimated from the first thousand slots
+    int hashfull() const;
 
     auto getPopulatedEntries() const{
         std::vector<TTEntry> result;
@@ -0,0 +1,49 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#ifndef CHESS_UCIWRITER_H
+#define CHESS_UCIWRITER_H
+
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <string_view>
+
+/*
+ * Collects UCI output lines and writes them out in batches. The search thread
+ * queues a burst of info lines then flushes once; replies that the GUI is waiting
+ * on (readyok, bestmove) go out immediately through send().
+ */
+class UciWriter {
+public:
+
+    explicit UciWriter(std::ostream& out = std::cout) : out_(out){}
+
+    // queue a line for the next flush
+    void line(std::string_view text);
+    // queue a line and flush everything queued so far
+    void send(std::string_view text);
+    void flush();
+
+    // drop everything instead, for engines that are played in-process and have no GUI listening
+    void setMuted(const bool muted){
+        std::lock_guard lock(mutex_);
+        muted_ = muted;
+        buffer_.clear();
+    }
+
+private:
+
+    void flushLocked();
+
+    std::ostream& out_;
+    std::string buffer_;
+    std::mutex mutex_;
+    bool muted_ = false;
+};
+
+// "cp <n>" or "mate <moves>", where a negative mate means we're the ones being mated
+std::string formatUciScore(float score);
+
+#endif //CHESS_UCIWRITER_H
@@ -5,6 +5,7 @@
 #ifndef ZOBRISTHASH_H
 #define ZOBRISTHASH_H
 #include <array>
+#include <cstdint>
 #include <random>
 
 
@@ -26,12 +27,24 @@ public:
 
     void setFen(const FenString& fenString);
     const uint64_t& getHash() const{ return hashValue; }
+    void setHash(const uint64_t hash){ hashValue = hash; }
+    // a null move only changes who is to move
+    void toggleSideToMove(){ hashValue ^= blackToMove; }
+    // rights and the en passant square are board state rather than part of a move, so the board manager
+    // xors the before and after in once it knows them
+    void updateCastlingRights(const uint8_t before, const uint8_t after){
+        hashValue ^= castlingKeys[before] ^ castlingKeys[after];
+    }
+    void updateEnPassantSquare(const int before, const int after){
+        hashValue ^= enPassantKey(before) ^ enPassantKey(after);
+    }
     void addMove(const Move& move);
     void undoMove(const Move& move);
 
 private:
 
     std::array<uint64_t, 64>& getArray(char pieceIndex);
+    uint64_t enPassantKey(const int square) const{ return square < 0 ? 0ULL : enPassantFiles[square % 8]; }
     void fillRandomArray(std::array<uint64_t, 64>& array);
     void initZobrist();
 
@@ -56,6 +69,9 @@ private:
 
 
     uint64_t blackToMove;
+    // one key per combination of the four rights, no rights hashes to nothing
+    std::array<uint64_t, 16> castlingKeys;
+    std::array<uint64_t, 8> enPassantFiles;
 };
 
 
@@ -17,6 +17,9 @@ public:
     }
 
 
+    bool empty() const{ return openingPositions.empty(); }
+    size_t size() const{ return openingPositions.size(); }
+
     FenString GetRandomFen(){
         int line = rng() % openingPositions.size();
         return openingPositions[line];
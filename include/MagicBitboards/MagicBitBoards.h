@@ -173,13 +173,16 @@ public:
     Bitboard getRookAttacks(int square, Bitboard occupancy) const;
     Bitboard getBishopAttacks(int square, Bitboard occupancy) const;
 
-    Bitboard getMoves(int square, const Piece& piece, const BitBoards& boards);
+    // castling destinations only show up for the rights passed in - none by default
+    Bitboard getMoves(int square, const Piece& piece, const BitBoards& boards, uint8_t castlingRights = 0);
 
     Rules rules;
     Bitboard findAttacksForColour(const Colours& colourToGetAttacksFor, const BitBoards& boards);
     Bitboard findAttacksForPiece(Piece piece, const BitBoards& boards);
     Bitboard findAttacksForPiece(Piece piece, const BitBoards& boards, const Bitboard& mask);
-    Bitboard getCastling(int square, const Piece& piece, const BitBoards& boards);
+    Bitboard getCastling(int square, const Piece& piece, const BitBoards& boards, uint8_t castlingRights);
+    bool isSquareAttacked(int square, const Colours& byColour, const BitBoards& boards);
+    Bitboard attackersTo(int square, const Colours& byColour, const BitBoards& boards);
 
     BitBoards bitBoards{};
 
@@ -16,6 +16,7 @@ public:
     void operator()(const UCICommand& cmd, MatchManager* matchManager);
     void operator()(const StopCommand& cmd, MatchManager* matchManager);
     void operator()(const IsReadyCommand& cmd, MatchManager* matchManager);
+    void operator()(const PonderHitCommand& cmd, MatchManager* matchManager);
     void operator()(const QuitCommand& cmd, MatchManager* matchManager);
     void operator()(const GoCommand& cmd, MatchManager* matchManager);
     void operator()(const PositionCommand& cmd, MatchManager* matchManager);
@@ -23,6 +24,8 @@ public:
     void operator()(const NewGameCommand& cmd, MatchManager* matchManager);
     void operator()(const IDCommand& cmd, MatchManager* matchManager);
     void operator()(const SetIDCommand& cmd, MatchManager* matchManager);
+    void operator()(const SetOptionCommand& cmd, MatchManager* matchManager);
+    void operator()(const BenchCommand& cmd, MatchManager* matchManager);
 
 
     static void generateFullPositionCommand(MatchManager* matchManager, std::string& fullPositionCommand);
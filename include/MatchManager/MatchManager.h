@@ -49,7 +49,7 @@ public:
 
     void handleNoMove();
 
-    std::stack<Move>& getMoveHistory();
+    const std::vector<Move>& getMoveHistory();
     void swapPlayers(){ std::swap(currentPlayer_, otherPlayer_); }
     void addMove(const std::string& moveUCI);
 
@@ -0,0 +1,152 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#ifndef CHESS_MATCHRUNNER_H
+#define CHESS_MATCHRUNNER_H
+
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "Engine/ChessPlayer.h"
+#include "MatchManager/MatchStatistics.h"
+#include "Utility/Fen.h"
+
+class ChessEngine;
+class InProcessPlayer;
+
+/*
+ * Headless engine-vs-engine matches. Unlike MatchManager there's no GUI tick driving it - each game
+ * runs start to finish on a pool worker, and the workers play their games side by side. Openings are
+ * played twice with the colours swapped, so a lopsided opening costs both engines equally.
+ */
+
+struct MatchTimeControl {
+    int baseMs = 10000;
+    int incrementMs = 100;
+    // either of these replaces the clock, the engines then get unlimited time to reach them
+    std::optional<int> depth;
+    std::optional<int> moveTimeMs;
+};
+
+struct MatchConfig {
+    // rounded up to a whole number of opening pairs - the most that will be played when there's an SPRT
+    int games = 100;
+    int concurrency = 1;
+    MatchTimeControl timeControl;
+    // games that reach this many plies are scored as draws
+    int maxPlies = 400;
+    // how far past its clock an engine can go before it loses on time - covers the pipe round trip
+    int timeMarginMs = 100;
+    // the wait for a reply when there's no clock to run out, e.g. depth limited games or isready
+    int replyTimeoutMs = 60000;
+    // one per game pair, game i plays openings[i / 2] - falls back to the start position when empty
+    std::vector<FenString> openings;
+    // stop as soon as the test accepts either hypothesis
+    std::optional<SprtConfig> sprt;
+};
+
+enum class GameOutcome {
+    WHITE_WIN,
+    BLACK_WIN,
+    DRAW
+};
+
+struct GameRecord {
+    int index = 0;
+    FenString openingFen;
+    bool engineAIsWhite = true;
+    GameOutcome outcome = GameOutcome::DRAW;
+    // checkmate, stalemate, repetition, fifty moves, max plies, illegal move, time, no reply, crashed
+    std::string reason;
+    std::vector<std::string> moves;
+
+    // 1, 0.5 or 0 for engine A
+    MatchScore scoreForA() const;
+};
+
+// running totals, updated after every game - pentanomial and SPRT only count pairs with both games played
+struct MatchProgress {
+    MatchScore score;
+    PentanomialScore pentanomial;
+    std::optional<SprtResult> sprt;
+};
+
+struct MatchResult : MatchProgress {
+    // only the games that were played, in order - an SPRT can stop the match early
+    std::vector<GameRecord> games;
+};
+
+/*
+ * Line oriented UCI over a ChessPlayer. readResponse() hands back whatever the player has, which can be
+ * several lines or a partial one, so the remainder is kept for the next read. A line only counts once its
+ * '\n' arrives, so players have to terminate every line they send.
+ */
+class UciChannel {
+public:
+
+    using Clock = std::chrono::steady_clock;
+
+    explicit UciChannel(std::unique_ptr<ChessPlayer> player) : player_(std::move(player)){}
+
+    bool send(const std::string& command);
+    // the next complete line, or nothing if the deadline passes or the player's output closes first
+    std::optional<std::string> readLine(Clock::time_point deadline);
+    // read until a line starting with token turns up, dropping everything before it
+    std::optional<std::string> waitFor(const std::string& token, Clock::time_point deadline);
+
+    // uci / uciok, then isready / readyok
+    bool handshake(int timeoutMs);
+
+    // the player has gone away, so waiting any longer for it is pointless
+    bool closed() const{ return player_->outputClosed() && pending_.find('\n') == std::string::npos; }
+
+private:
+
+    std::unique_ptr<ChessPlayer> player_;
+    std::string pending_;
+};
+
+class MatchRunner {
+public:
+
+    // called with 0 for engine A and 1 for engine B - may be called from several workers at once
+    using PlayerFactory = std::function<std::unique_ptr<ChessPlayer>(int engineIndex)>;
+    // called after every game under a lock, with the running totals for engine A
+    using GameCallback = std::function<void(const GameRecord& game, const MatchProgress& progress)>;
+
+    // in-process engines, played directly with no UCI in between
+    using EngineFactory = std::function<std::unique_ptr<ChessEngine>(int engineIndex)>;
+
+    MatchRunner(PlayerFactory factory, MatchConfig config);
+    // a ChessEngine is a ChessPlayer too, so this is named rather than another constructor
+    static MatchRunner inProcess(EngineFactory factory, MatchConfig config);
+
+    MatchResult run(const GameCallback& onGameFinished = {});
+
+    // plays one game to a result - white and black must already have been through the handshake
+    static GameRecord playGame(UciChannel& white, UciChannel& black, const FenString& openingFen,
+                               const MatchConfig& config);
+
+    // the same game between two in-process engines
+    static GameRecord playGame(InProcessPlayer& white, InProcessPlayer& black, const FenString& openingFen,
+                               const MatchConfig& config);
+
+    static MatchScore tally(const std::vector<GameRecord>& games);
+
+private:
+
+    template<typename Seat>
+    MatchResult runSeats(const std::function<std::unique_ptr<Seat>(int engineIndex)>& makeSeat,
+                         const GameCallback& onGameFinished);
+
+    PlayerFactory factory_;
+    EngineFactory engineFactory_;
+    MatchConfig config_;
+};
+
+#endif //CHESS_MATCHRUNNER_H
@@ -0,0 +1,92 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#ifndef CHESS_MATCHSTATISTICS_H
+#define CHESS_MATCHSTATISTICS_H
+
+#include <array>
+#include <string>
+
+// results from the point of view of the engine under test
+struct MatchScore {
+    int wins = 0;
+    int draws = 0;
+    int losses = 0;
+
+    int games() const{ return wins + draws + losses; }
+    // points per game, 0 to 1
+    double score() const{ return games() == 0 ? 0.5 : (wins + 0.5 * draws) / games(); }
+
+    MatchScore& operator+=(const MatchScore& rhs){
+        wins += rhs.wins;
+        draws += rhs.draws;
+        losses += rhs.losses;
+        return *this;
+    }
+};
+
+struct EloEstimate {
+    double elo = 0.0;
+    // half width of the 95% confidence interval, in Elo
+    double errorMargin = 0.0;
+    // likelihood of superiority - chance the engine under test really is the stronger one
+    double los = 0.5;
+
+    std::string toString() const;
+};
+
+// logistic Elo difference for a score fraction, clamped away from +-infinity at 0% and 100%
+double scoreToElo(double score);
+// and back, the expected score per game for an Elo difference
+double eloToScore(double elo);
+
+EloEstimate estimateElo(const MatchScore& score);
+
+/*
+ * Game pairs - one opening played twice with the colours swapped - bucketed by engine A's points over
+ * the pair: 0, 0.5, 1, 1.5 or 2. The two games of a pair share their opening's bias, so counting pairs
+ * rather than games gives a smaller, more honest variance and lets the SPRT finish sooner.
+ */
+struct PentanomialScore {
+    std::array<int, 5> pairs{};
+
+    // both games of one pair, from engine A's point of view
+    void addPair(const MatchScore& pair){ pairs[pair.wins * 2 + pair.draws]++; }
+    int total() const{ return pairs[0] + pairs[1] + pairs[2] + pairs[3] + pairs[4]; }
+
+    std::string toString() const;
+};
+
+// H0: the change is worth elo0, H1: it's worth elo1 - alpha and beta are the false positive / negative rates
+struct SprtConfig {
+    double elo0 = 0.0;
+    double elo1 = 5.0;
+    double alpha = 0.05;
+    double beta = 0.05;
+};
+
+enum class SprtDecision {
+    CONTINUE,
+    ACCEPT_H0,
+    ACCEPT_H1
+};
+
+struct SprtResult {
+    // log likelihood ratio of H1 over H0
+    double llr = 0.0;
+    double lowerBound = 0.0;
+    double upperBound = 0.0;
+    SprtDecision decision = SprtDecision::CONTINUE;
+
+    std::string toString() const;
+};
+
+/*
+ * Generalised SPRT on the pentanomial distribution, in logistic Elo. Each hypothesis is the closest
+ * distribution to the observed one that has its mean score, and the LLR compares the two - so no
+ * single pair can move it by more than a bounded amount, however few pairs there are.
+ */
+SprtResult sprt(const PentanomialScore& score, const SprtConfig& config);
+
+#endif //CHESS_MATCHSTATISTICS_H
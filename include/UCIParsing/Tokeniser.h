@@ -4,21 +4,23 @@
 
 #ifndef TOKENISER_H
 #define TOKENISER_H
-#include <string>
+#include <string_view>
 #include <vector>
 
 enum class TokenType {
     // simple interactions
     UCI, QUIT, ISREADY, UCI_NEW_GAME, STOP,
     // move setting
-    POSITION_CMD, START_POS, FEN_BODY, MOVES, MOVE_VALUE, BESTMOVE,
+    POSITION_CMD, START_POS, FEN, FEN_BODY, MOVES, MOVE_VALUE, BESTMOVE,
 
     // go and it's options
-    GO, DEPTH,
+    GO, DEPTH, GO_INFINITE, NODES, PONDER, PONDERHIT,
 
     // misc engine options
     DEBUG, ON, OFF,
     REGISTER, SETOPTION, ID,
+    // not UCI - searches the fixed bench positions
+    BENCH,
 
     // literals
     INT_LITERAL, STRING_LITERAL, DASH,
@@ -26,34 +28,39 @@ enum class TokenType {
     // parser utilities
     EOF_TOKEN, UNKNOWN,
 
-    // option setting
+    // option setting - "name" and "value" inside a setoption
     SET, SET_OPTION, SET_VALUE,
 
     // time control
-    WTIME, BTIME, WINC, BINC,
+    WTIME, BTIME, WINC, BINC, MOVESTOGO, MOVETIME,
 };
 
+// value is a view into the line being tokenised, so it's only valid while that line is
 struct Token {
     TokenType type;
-    std::string value;
+    std::string_view value;
 };
 
 class Tokeniser {
 public:
 
-    explicit Tokeniser(const std::string& input);
+    Tokeniser() = default;
+    explicit Tokeniser(std::string_view input);
+
+    // re-tokenise a new line, reusing the token storage
+    void tokenise(std::string_view input);
     std::vector<Token>& getTokens(){ return tokens; }
 
-    static bool isMove(const std::string& token);
-    static bool isPosition(const std::string& token);
-    static bool isIntLiteral(const std::string& token);
-    static bool isStringLiteral(const std::string& token);
+    static bool isMove(std::string_view token);
+    static bool isPosition(std::string_view token);
+    static bool isIntLiteral(std::string_view token);
+    static bool isStringLiteral(std::string_view token);
 
 private:
 
-    void tokenise(const std::string& input);
     std::vector<Token> tokens;
-    void handleToken(std::string& builtToken);
-    static TokenType getUnknownTokenType(const std::string& token);
+    void handleToken(std::string_view token);
+    static TokenType getKeywordType(std::string_view token);
+    static TokenType getUnknownTokenType(std::string_view token);
 };
-#endif //TOKENISER_H
\ No newline at end of file
+#endif //TOKENISER_H
@@ -4,8 +4,10 @@
 
 #ifndef UCIPARSER_H
 #define UCIPARSER_H
+#include <cstdint>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <variant>
 
 #include <vector>
@@ -21,12 +23,19 @@ struct QuitCommand {};
 
 struct IsReadyCommand {};
 
+struct PonderHitCommand {};
+
 struct GoCommand {
     std::optional<int> depth;
     std::optional<int> wtime;
     std::optional<int> btime;
     std::optional<int> winc;
     std::optional<int> binc;
+    std::optional<int> movestogo;
+    std::optional<int> movetime;
+    std::optional<uint64_t> nodes;
+    bool infinite = false;
+    bool ponder = false;
 };
 
 struct PositionCommand {
@@ -49,6 +58,15 @@ struct SetIDCommand {
     std::string id;
 };
 
+struct SetOptionCommand {
+    std::string name;
+    std::string value;
+};
+
+struct BenchCommand {
+    std::optional<int> depth;
+};
+
 
 using Command = std::variant<
     UCICommand,
@@ -56,22 +74,26 @@ using Command = std::variant<
     StopCommand,
     QuitCommand,
     IsReadyCommand,
+    PonderHitCommand,
     PositionCommand,
     BestMoveCommand,
     NewGameCommand,
     IDCommand,
-    SetIDCommand
+    SetIDCommand,
+    SetOptionCommand,
+    BenchCommand
 >;
 
 class UCIParser {
 public:
 
-    std::optional<Command> parse(const std::string& parseTarget);
+    // the returned command owns its strings, so parseTarget only needs to outlive this call
+    std::optional<Command> parse(std::string_view parseTarget);
 
 private:
 
     int currentToken = 0;
-    std::vector<Token> tokens;
+    Tokeniser tokeniser; // kept between parses so its token storage is reused
 
     Token peek();
     Token consume();
@@ -80,6 +102,8 @@ private:
     std::optional<Command> parseGo();
     std::optional<Command> parseBestMove();
     std::optional<Command> parseSetIDCommand();
+    std::optional<Command> parseSetOption();
+    std::optional<Command> parseBench();
 };
 
 
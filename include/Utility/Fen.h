@@ -20,6 +20,10 @@ namespace Fen {
     inline const FenString FULL_KIWI_PETE_FEN = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1";
     inline const FenString POSITION_3_FEN = "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8";
     inline const FenString FULL_POSITION_3_FEN = "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1";
+    inline const FenString FULL_POSITION_4_FEN = "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1";
+    inline const FenString FULL_POSITION_5_FEN = "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8";
+    inline const FenString FULL_POSITION_6_FEN =
+            "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10";
 
     inline FenString rankAndFileToFen(const int rank, const int file){
         FenString returnString;
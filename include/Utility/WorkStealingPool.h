@@ -0,0 +1,68 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#ifndef CHESS_WORKSTEALINGPOOL_H
+#define CHESS_WORKSTEALINGPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+ * Fixed set of worker threads, each with its own task deque. Submitted tasks are dealt
+ * round-robin; a worker takes from the back of its own deque and, once that's empty,
+ * steals from the front of someone else's. Tasks get the index of the worker running
+ * them so callers can keep per-worker state (e.g. one board each).
+ */
+class WorkStealingPool {
+public:
+
+    using Task = std::function<void(int workerIndex)>;
+
+    explicit WorkStealingPool(int threadCount);
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    int size() const{ return static_cast<int>(threads_.size()); }
+
+    void submit(Task task);
+    // block until every task submitted so far has finished
+    void wait();
+
+    // hardware_concurrency, but never 0
+    static int defaultThreadCount();
+
+private:
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    void workerLoop(int index);
+    bool popLocal(int index, Task& task);
+    bool steal(int thief, Task& task);
+
+    std::vector<std::unique_ptr<WorkerQueue> > queues_;
+    std::vector<std::thread> threads_;
+
+    // tasks sitting in a deque, and tasks not yet finished
+    std::atomic<size_t> queued_ = 0;
+    std::atomic<size_t> pending_ = 0;
+    std::atomic<size_t> nextQueue_ = 0;
+
+    std::mutex sleepMutex_;
+    std::condition_variable workAvailable_;
+    std::condition_variable allDone_;
+    bool stopping_ = false;
+};
+
+#endif //CHESS_WORKSTEALINGPOOL_H
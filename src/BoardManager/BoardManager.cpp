@@ -3,6 +3,7 @@
 
 #include "BoardManager/BoardManager.h"
 
+#include <algorithm>
 #include <iostream>
 #include <sstream>
 
@@ -11,6 +12,19 @@
 #include "BoardManager/Referee.h"
 #include "Utility/Fen.h"
 
+// rights that survive a piece moving from or to each square - only the king and rook home squares clear anything
+constexpr std::array<uint8_t, 64> CASTLING_RIGHTS_MASK = []{
+    std::array<uint8_t, 64> mask{};
+    mask.fill(ALL_CASTLING_RIGHTS);
+    mask[0] &= ~WHITE_QUEENSIDE; // a1
+    mask[7] &= ~WHITE_KINGSIDE; // h1
+    mask[4] &= ~(WHITE_KINGSIDE | WHITE_QUEENSIDE); // e1
+    mask[56] &= ~BLACK_QUEENSIDE; // a8
+    mask[63] &= ~BLACK_KINGSIDE; // h8
+    mask[60] &= ~(BLACK_KINGSIDE | BLACK_QUEENSIDE); // e8
+    return mask;
+}();
+
 
 /**
 * Checks if a move is legal - in all elements other than if it leaves the moving king in check
@@ -23,7 +37,8 @@ bool BoardManager::validateMove(Move& move){
         move,
         bitboards(),
         magicBitBoards,
-        boardStateHistory.top().enPassantSquare
+        position().enPassantSquare,
+        position().castlingRights
     );
 }
 
@@ -34,17 +49,13 @@ bool BoardManager::validateMove(Move& move){
 * @return boolean success
 **/
 bool BoardManager::checkMove(Move& move){
-    if (boardStateHistory.empty()) {
-        boardStateHistory.push(
-            BoardState{.enPassantSquare = -1, .castlingRights = ""}
-        );
-    }
     const bool isPseudoLegal =
             Referee::moveIsLegal(
                 move,
                 bitboards(),
                 magicBitBoards,
-                boardStateHistory.top().enPassantSquare
+                position().enPassantSquare,
+                position().castlingRights
             );
     if (!isPseudoLegal) { return false; } // move not even pseudolegal
 
@@ -54,7 +65,7 @@ bool BoardManager::checkMove(Move& move){
     auto status = Referee::checkBoardStatus(
         bitboards(),
         magicBitBoards,
-        currentTurn
+        getCurrentTurn()
     );
 
     // no checks
@@ -68,7 +79,7 @@ bool BoardManager::checkMove(Move& move){
     bool whiteInCheckOrMate = status & (WHITE_CHECK | WHITE_CHECKMATE);
 
     // leaves the previous turn to move in check
-    if (blackInCheckOrMate && currentTurn == WHITE || whiteInCheckOrMate && currentTurn == BLACK) {
+    if (blackInCheckOrMate && getCurrentTurn() == WHITE || whiteInCheckOrMate && getCurrentTurn() == BLACK) {
         bitboards().undoMove(move);
         swapTurns();
         move.resultBits = ILLEGAL_MOVE;
@@ -80,7 +91,6 @@ bool BoardManager::checkMove(Move& move){
         move.resultBits |= CHECK;
         move.resultBits &= ~PUSH;
         move.resultBits |= CHECK_MATE;
-        checkMateFlag = true;
         bitboards().undoMove(move);
         swapTurns();
         return true;
@@ -144,71 +154,179 @@ bool BoardManager::forceMove(Move& move){
 * @param move - the move to be applied. This should have been checked before.
 **/
 void BoardManager::makeMove(Move& move){
-    BoardState newBoardState;
+    Position& next = pushPosition();
+    const int previousEnPassant = next.enPassantSquare;
+    const uint8_t previousCastlingRights = next.castlingRights;
 
     // handle the EP square
-    int enPassantSquareState;
     if ((move.piece == WP || move.piece == BP)
         && move.fileTo == move.fileFrom
         && abs(move.rankTo - move.rankFrom) == 2
     ) {
         // a pawn has moved 2 ranks - and exposed an en passant square - update our state tracker
         const auto targetRank = move.piece == WP ? move.rankTo - 1 : move.rankTo + 1;
-        enPassantSquareState = rankAndFileToSquare(targetRank, move.fileFrom);
+        next.enPassantSquare = rankAndFileToSquare(targetRank, move.fileFrom);
     } else {
         // any other move means the en passant square is now invalid
-        enPassantSquareState = -1;
+        next.enPassantSquare = -1;
     }
 
+    // pawn moves and captures can't be undone, so they restart the fifty move count
+    if (move.piece == WP || move.piece == BP || move.resultBits & CAPTURE)
+        next.halfMoveClock = 0;
+    else
+        next.halfMoveClock++;
+
+    // anything leaving or landing on a king or rook home square loses the rights tied to it
+    const int fromSquare = rankAndFileToSquare(move.rankFrom, move.fileFrom);
+    const int toSquare = rankAndFileToSquare(move.rankTo, move.fileTo);
+    next.castlingRights &= CASTLING_RIGHTS_MASK[fromSquare] & CASTLING_RIGHTS_MASK[toSquare];
+
+    if (next.sideToMove == BLACK) { next.fullMoveNumber++; }
+    next.pliesFromNull++;
+
     bitboards().applyMove(move);
     swapTurns();
 
     zobristHash_.addMove(move);
+    zobristHash_.updateCastlingRights(previousCastlingRights, next.castlingRights);
+    zobristHash_.updateEnPassantSquare(previousEnPassant, next.enPassantSquare);
+    next.hash = zobristHash_.getHash();
 
-    repetitionTable_New_.addMove(zobristHash_.getHash());
-    if (repetitionTable_New_.checkForRepetition()) { repetitionFlag = true; }
-
-    moveHistory.emplace(move);
-    boardStateHistory.emplace(BoardState{.enPassantSquare = enPassantSquareState, .castlingRights = ""});
+    moveHistory.push_back(move);
 }
 
+Position& BoardManager::pushPosition(){
+    if (ply_ + 1 == positions_.size()) { positions_.resize(positions_.size() * 2); }
 
-void BoardManager::swapTurns(){
-    if (currentTurn == WHITE)
-        currentTurn = BLACK;
-    else
-        currentTurn = WHITE;
+    // the live board is the source of truth for the current ply - it can be edited from outside
+    Position& current = positions_[ply_];
+    current.bitboards = bitboards().getRawBoards();
+    current.hash = zobristHash_.getHash();
+
+    positions_[ply_ + 1] = current;
+    return positions_[++ply_];
 }
 
-void BoardManager::undoMove(const Move& move){
-    bitboards().undoMove(move);
+void BoardManager::popPosition(){
+    --ply_;
+    const Position& previous = positions_[ply_];
+    bitboards().setRawBoards(previous.bitboards);
+    zobristHash_.setHash(previous.hash);
+}
 
-    moveHistory.pop();
-    boardStateHistory.pop();
 
-    swapTurns();
+void BoardManager::swapTurns(){
+    Position& current = position();
+    current.sideToMove = current.sideToMove == WHITE ? BLACK : WHITE;
+}
 
-    repetitionTable_New_.popMove();
-    zobristHash_.undoMove(move);
-    repetitionFlag = false;
-    checkMateFlag = false; // can never undo into a checkmate position
+void BoardManager::undoMove(const Move&){
+    if (ply_ == 0) { return; }
+    popPosition();
+    moveHistory.pop_back();
 }
 
 void BoardManager::undoMove(){
     if (moveHistory.empty())
         return;
-    undoMove(moveHistory.top());
+    undoMove(moveHistory.back());
 }
 
-void BoardManager::makeNullMove(){ swapTurns(); }
+void BoardManager::makeNullMove(){
+    Position& next = pushPosition();
+    zobristHash_.updateEnPassantSquare(next.enPassantSquare, -1);
+    next.enPassantSquare = -1;
+    next.halfMoveClock++;
+    // nothing before a null move can be repeated by a real line of play
+    next.pliesFromNull = 0;
+    swapTurns();
+    zobristHash_.toggleSideToMove();
+    next.hash = zobristHash_.getHash();
+}
 
-bool BoardManager::threefoldRepetition(){ return repetitionFlag; }
+void BoardManager::undoNullMove(){ popPosition(); }
+
+/**
+* Looks back for an earlier occurrence of the current position. Only positions since the last pawn move, capture
+* or null move can match, so the scan stops there rather than going back through the whole game
+* @param pliesFromRoot - how deep into a search we are. A position seen once already inside the search tree counts
+* as a draw; anything from before the search still needs to have been seen twice
+* @return true if the position should be scored as a draw
+**/
+bool BoardManager::isRepetition(const int pliesFromRoot) const{
+    const Position& current = position();
+    const int window = std::min(current.halfMoveClock, current.pliesFromNull);
+    const int earliest = std::max(0, static_cast<int>(ply_) - window);
+    const int root = static_cast<int>(ply_) - pliesFromRoot;
+
+    // it takes at least four plies to get back to the same position with the same side to move
+    int matchCounter = 0;
+    for (int i = static_cast<int>(ply_) - 4; i >= earliest; i -= 2) {
+        if (positions_[i].hash != current.hash) { continue; }
+        if (i > root) { return true; }
+        if (++matchCounter == 2) { return true; }
+    }
+    return false;
+}
+
+bool BoardManager::threefoldRepetition() const{ return isRepetition(0); }
+
+bool BoardManager::isFiftyMoveDraw() const{ return position().halfMoveClock >= 100; }
+
+Bitboard BoardManager::getCheckers(){
+    const Colours us = getCurrentTurn();
+    const Bitboard king = bitboards()[us == WHITE ? WK : BK];
+    if (!king) { return 0ULL; } // test positions don't always have one
+    return magicBitBoards.attackersTo(std::countr_zero(king), us == WHITE ? BLACK : WHITE, bitboards());
+}
+
+/**
+* Stops at the first legal move found, so it's much cheaper than generating the full list when all we need to know
+* is whether the game has ended
+* @return true if the side to move has at least one legal move
+**/
+bool BoardManager::hasAnyLegalMoves(){
+    const Colours us = getCurrentTurn();
+    const Colours them = us == WHITE ? BLACK : WHITE;
+    const Piece ourKing = us == WHITE ? WK : BK;
+
+    for (const auto piece: filteredPieces[us]) {
+        Bitboard pieceSquares = bitboards()[piece];
+        while (pieceSquares) {
+            const int fromSquare = popLowestSetBit(pieceSquares);
+            Bitboard destinations = magicBitBoards.getMoves(fromSquare, piece, bitboards(), position().castlingRights);
+            while (destinations) {
+                const int toSquare = popLowestSetBit(destinations);
+                auto move = Move(piece, fromSquare, toSquare);
+
+                // any promotion will do, if one is legal they all are
+                if ((piece == WP && toSquare >= 56) || (piece == BP && toSquare <= 7)) {
+                    move.promotedPiece = piece == WP ? WQ : BQ;
+                }
+                if (!validateMove(move)) { continue; }
+
+                bitboards().applyMove(move);
+                const Bitboard king = bitboards()[ourKing];
+                const bool leavesKingSafe = !king || !magicBitBoards.isSquareAttacked(
+                                                std::countr_zero(king), them, bitboards());
+                bitboards().undoMove(move);
+
+                if (leavesKingSafe) { return true; }
+            }
+        }
+    }
+    return false;
+}
+
+bool BoardManager::isCheckmate(){ return isInCheck() && !hasAnyLegalMoves(); }
+
+bool BoardManager::isStalemate(){ return !isInCheck() && !hasAnyLegalMoves(); }
 
 bool BoardManager::isGameOver(){
-    if (moveHistory.size() >= 100) { return true; }
-    if (checkMateFlag) { return true; }
+    if (!hasAnyLegalMoves()) { return true; }
+    if (isFiftyMoveDraw()) { return true; }
     if (threefoldRepetition()) { return true; }
-    if (Referee::isStalemate()) { return true; }
 
     return false;
 }
@@ -216,7 +334,12 @@ bool BoardManager::isGameOver(){
 int BoardManager::getGameResult(){
     int resultBits = 0;
 
-    if (moveHistory.size() >= 100) {
+    // no moves at all is mate or stalemate, depending on whether we're in check
+    const bool noLegalMoves = !hasAnyLegalMoves();
+    const bool inCheck = isInCheck();
+
+    // mate on the hundredth ply still counts as mate
+    if (isFiftyMoveDraw() && !(noLegalMoves && inCheck)) {
         resultBits |= GameResult::DRAW;
         resultBits |= GameResult::MOVE_COUNT;
         return resultBits;
@@ -228,8 +351,8 @@ int BoardManager::getGameResult(){
         return resultBits;
     }
 
-    const auto lastMoveColour = currentTurn == WHITE ? BLACK : WHITE;
-    if (checkMateFlag) {
+    const auto lastMoveColour = getCurrentTurn() == WHITE ? BLACK : WHITE;
+    if (noLegalMoves && inCheck) {
         resultBits |= GameResult::CHECKMATE;
 
         if (lastMoveColour == WHITE)
@@ -240,7 +363,8 @@ int BoardManager::getGameResult(){
         return resultBits;
     }
 
-    if (Referee::isStalemate()) {
+    if (noLegalMoves) {
+        resultBits |= GameResult::DRAW;
         resultBits |= GameResult::STALEMATE;
         return resultBits;
     }
@@ -261,18 +385,32 @@ void BoardManager::setFullFen(const FenString& fen){
     fenStream >> fenPiecePlacement >> fenActiveColour >> fenCastling >> fenEnPassant >> fenHalfMoveClock >>
             fenFullMoveNumber;
 
-    const auto enPassantSquare = fenEnPassant == "-" ? -1 : Fen::FenToSquare(fenEnPassant);
-    boardStateHistory.emplace(BoardState{.enPassantSquare = enPassantSquare});
+    // a new position means a new game - no history to undo into
+    moveHistory.clear();
+    ply_ = 0;
+
     bitboards().setFenPositionOnly(fenPiecePlacement);
-    setCurrentTurn(fenActiveColour == "w" ? WHITE : BLACK);
     zobristHash_.setFen(fen);
+
+    Position& start = position();
+    start = Position{};
+    start.bitboards = bitboards().getRawBoards();
+    start.hash = zobristHash_.getHash();
+    start.enPassantSquare = fenEnPassant.empty() || fenEnPassant == "-" ? -1 : Fen::FenToSquare(fenEnPassant);
+    start.halfMoveClock = fenHalfMoveClock.empty() ? 0 : std::stoi(fenHalfMoveClock);
+    start.fullMoveNumber = fenFullMoveNumber.empty() ? 1 : std::stoi(fenFullMoveNumber);
+    start.sideToMove = fenActiveColour == "b" ? BLACK : WHITE;
+    // a placement-only fen gets the same benefit of the doubt as a fresh board
+    start.castlingRights = fenCastling.empty() ? ALL_CASTLING_RIGHTS : castlingRightsFromFen(fenCastling);
 }
 
 std::string BoardManager::getFullFen(){
     const auto baseFen = bitboards().getFenPositionOnly();
-    const auto enPassantSquareString = (boardStateHistory.top().enPassantSquare == -1)
+    const auto enPassantSquareString = (position().enPassantSquare == -1)
                                            ? "-"
-                                           : Fen::squareToFen(boardStateHistory.top().enPassantSquare);
-    auto resultFen = baseFen + (currentTurn == WHITE ? " w" : " b") + " KQkq " + enPassantSquareString + " 0 1";
+                                           : Fen::squareToFen(position().enPassantSquare);
+    auto resultFen = baseFen + (getCurrentTurn() == WHITE ? " w " : " b ")
+                     + castlingRightsToFen(position().castlingRights) + " " + enPassantSquareString
+                     + " " + std::to_string(position().halfMoveClock) + " " + std::to_string(position().fullMoveNumber);
     return resultFen;
 }
\ No newline at end of file
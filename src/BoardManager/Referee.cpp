@@ -4,14 +4,17 @@
 
 #include "BoardManager/Referee.h"
 
+#include <cstdlib>
+
 #include "BoardManager/BitBoards.h"
 #include "BoardManager/Move.h"
 
 #include "Engine/ProcessChessEngine.h"
 
 
-bool Referee::moveIsLegal(Move& move, BitBoards& boardState, MagicBitBoards& mbb, const int enPassantSquare){
-    return validateMove(move, boardState, mbb, enPassantSquare);
+bool Referee::moveIsLegal(Move& move, BitBoards& boardState, MagicBitBoards& mbb, const int enPassantSquare,
+                          const uint8_t castlingRights){
+    return validateMove(move, boardState, mbb, enPassantSquare, castlingRights);
 }
 
 int Referee::checkBoardStatus(BitBoards& bitboards, MagicBitBoards& magicBitBoards,
@@ -45,10 +48,6 @@ int Referee::checkBoardStatus(BitBoards& bitboards, MagicBitBoards& magicBitBoar
     return result;
 }
 
-bool Referee::hasAnyLegalMoves(BitBoards& bitBoards, MagicBitBoards& magicBitBoards, Colours colourToMove){
-
-}
-
 bool Referee::boardIsInCheck(BitBoards& bitboards, MagicBitBoards& magicBitBoards, Colours colourToMove){
     return isKingInCheck(bitboards, magicBitBoards, colourToMove);
 }
@@ -71,7 +70,7 @@ void Referee::handleEnPassant(Move& move){
 }
 
 bool Referee::validateMove(Move& move, const BitBoards& bitboards, MagicBitBoards& magicBitBoards,
-                           const int enPassantSquare){
+                           const int enPassantSquare, const uint8_t castlingRights){
     // where are we going to?
     const int toSquare = rankAndFileToSquare(move.rankTo, move.fileTo);
     const Bitboard toSquareBitboard = 1ULL << toSquare;
@@ -88,7 +87,7 @@ bool Referee::validateMove(Move& move, const BitBoards& bitboards, MagicBitBoard
     const auto enemyPieces = bitboards.getOccupancy() & ~friendlyPieces;
 
     // just get all the possible moves, if the to square doesn't appear in all, the move is therefore not any form of legal
-    const auto allMoves = magicBitBoards.getMoves(fromSquare, move.piece, bitboards);
+    const auto allMoves = magicBitBoards.getMoves(fromSquare, move.piece, bitboards, castlingRights);
     if (!(allMoves & toSquareBitboard)) {
         move.resultBits |= ILLEGAL_MOVE;
         return false;
@@ -130,10 +129,8 @@ bool Referee::validateMove(Move& move, const BitBoards& bitboards, MagicBitBoard
         return false;
     }
 
-    if (const auto castlingMoves
-                = magicBitBoards.getCastling(fromSquare, move.piece, bitboards);
-        toSquareBitboard & castlingMoves
-    ) {
+    // the only way a king gets two files in one move is castling, and getMoves has already vetted that
+    if ((move.piece == WK || move.piece == BK) && std::abs(move.fileTo - move.fileFrom) == 2) {
         move.resultBits |= CASTLING;
         return true;
     }
@@ -246,7 +243,7 @@ bool Referee::hasLegalMoveToEscapeCheck(BitBoards& bitboards, MagicBitBoards& ma
 
 bool Referee::isValidEscapeMove(Move& move, BitBoards& bitboards, MagicBitBoards& magicBitBoards,
                                 const Colours currentTurn){
-    if (!validateMove(move, bitboards, magicBitBoards, currentTurn)) { return false; } // move not even pseudolegal
+    if (!validateMove(move, bitboards, magicBitBoards, -1, 0)) { return false; } // move not even pseudolegal
 
     // now we need to check the board state for check mates etc
     bitboards.applyMove(move);
@@ -2,15 +2,32 @@
 // Created by jacks on 05/08/2025.
 //
 
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <string_view>
 
 #include "Engine/ChessEngine.h"
 
 
-int main(){
+int main(const int argc, char* argv[]){
     auto engine = ChessEngine();
-    while (!engine.shouldQuit()) {
-        char input[1024];
-        std::cin.getline(input, 1024);
-        engine.sendCommand(input);
+
+    // "StandaloneEngine bench [depth]" runs the bench and exits, same as typing it at the prompt
+    if (argc > 1) {
+        const bool validDepth = argc < 3 || (std::string_view(argv[2]).find_first_not_of("0123456789") ==
+                                             std::string_view::npos && std::atoi(argv[2]) > 0);
+        if (std::string_view(argv[1]) != "bench" || argc > 3 || !validDepth) {
+            std::cerr << "usage: StandaloneEngine [bench [depth]]\n"
+                    << "  with no arguments it speaks UCI on stdin/stdout\n";
+            return 1;
+        }
+        engine.sendCommand(argc == 3 ? std::string("bench ") + argv[2] : "bench");
+        return 0;
     }
-}
\ No newline at end of file
+
+    // no fixed buffer - a long game's "position startpos moves ..." line must arrive whole
+    std::string input;
+    // searches run on their own thread, so this loop is always free to read "stop" / "isready"
+    while (!engine.shouldQuit() && std::getline(std::cin, input)) { engine.sendCommand(input); }
+}
@@ -0,0 +1,137 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include <atomic>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#include "Engine/ChessEngine.h"
+#include "Engine/ProcessChessEngine.h"
+#include "GUI/OpeningBook.h"
+#include "MatchManager/MatchRunner.h"
+#include "Utility/WorkStealingPool.h"
+
+namespace {
+    void printUsage(){
+        std::cerr << "usage: match_runner <engineA> <engineB> [options]\n"
+                << "       match_runner --selfplay [options]\n"
+                << "options: [--games <n>] [--concurrency <n>] [--tc <base>+<inc>] [--depth <plies>] [--movetime <ms>]\n"
+                << "         [--maxplies <n>] [--sprt elo0=<e> elo1=<e> [alpha=<a>] [beta=<b>]] [--quiet]\n"
+                << "  --tc is in seconds, e.g. 10+0.1 - results are from engineA's point of view\n"
+                << "  --selfplay plays this build against itself in-process, with no UCI pipes\n"
+                << "  --sprt stops as soon as the test is decided, --games is then the most it will play\n";
+    }
+
+    void parseTimeControl(const std::string& value, MatchTimeControl& timeControl){
+        const auto plus = value.find('+');
+        timeControl.baseMs = static_cast<int>(std::stod(value.substr(0, plus)) * 1000);
+        timeControl.incrementMs = plus == std::string::npos ? 0 : static_cast<int>(std::stod(value.substr(plus + 1)) * 1000);
+    }
+
+    std::string outcomeString(const GameOutcome outcome){
+        switch (outcome) {
+            case GameOutcome::WHITE_WIN:
+                return "1-0";
+            case GameOutcome::BLACK_WIN:
+                return "0-1";
+            default:
+                return "1/2-1/2";
+        }
+    }
+}
+
+int main(const int argc, char* argv[]){
+    const bool selfPlay = argc >= 2 && std::string_view(argv[1]) == "--selfplay";
+    if (argc < 3 && !selfPlay) {
+        printUsage();
+        return 1;
+    }
+
+    const std::string engineA = selfPlay ? "" : argv[1];
+    const std::string engineB = selfPlay ? "" : argv[2];
+    MatchConfig config;
+    config.concurrency = WorkStealingPool::defaultThreadCount();
+    bool quiet = false;
+
+    try {
+        for (int i = selfPlay ? 2 : 3; i < argc; i++) {
+            const std::string_view option = argv[i];
+            if (option == "--quiet") {
+                quiet = true;
+                continue;
+            }
+            if (option == "--sprt") {
+                // cutechess style key=value pairs, running up to the next option
+                SprtConfig sprt;
+                while (i + 1 < argc && !std::string_view(argv[i + 1]).starts_with("--")) {
+                    const std::string pair = argv[++i];
+                    const auto equals = pair.find('=');
+                    const auto key = pair.substr(0, equals);
+                    const double value = std::stod(pair.substr(equals + 1));
+                    if (key == "elo0") { sprt.elo0 = value; }
+                    else if (key == "elo1") { sprt.elo1 = value; }
+                    else if (key == "alpha") { sprt.alpha = value; }
+                    else if (key == "beta") { sprt.beta = value; }
+                    else {
+                        printUsage();
+                        return 1;
+                    }
+                }
+                config.sprt = sprt;
+                continue;
+            }
+            if (i + 1 >= argc) {
+                printUsage();
+                return 1;
+            }
+            const std::string value = argv[++i];
+            if (option == "--games") { config.games = std::stoi(value); }
+            else if (option == "--concurrency") { config.concurrency = std::stoi(value); }
+            else if (option == "--tc") { parseTimeControl(value, config.timeControl); }
+            else if (option == "--depth") { config.timeControl.depth = std::stoi(value); }
+            else if (option == "--movetime") { config.timeControl.moveTimeMs = std::stoi(value); }
+            else if (option == "--maxplies") { config.maxPlies = std::stoi(value); }
+            else {
+                printUsage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        printUsage();
+        return 1;
+    }
+
+    // the book is random, so draw every opening up front and the colour-swapped replays see the same one
+    OpeningBook book;
+    if (!book.empty()) {
+        for (int pair = 0; pair < (config.games + 1) / 2; pair++) { config.openings.push_back(book.GetRandomFen()); }
+    } else { std::cerr << "opening book is empty, every game starts from the start position" << std::endl; }
+
+    std::atomic<int> enginesStarted = 0;
+    auto runner = selfPlay
+                      ? MatchRunner::inProcess([](int) { return std::make_unique<ChessEngine>(); }, config)
+                      : MatchRunner([&](const int engineIndex) -> std::unique_ptr<ChessPlayer> {
+                          const auto& path = engineIndex == 0 ? engineA : engineB;
+                          return std::make_unique<ProcessChessEngine>(path, "Match" + std::to_string(enginesStarted++));
+                      }, config);
+
+    const auto result = runner.run([&](const GameRecord& game, const MatchProgress& progress){
+        if (quiet) { return; }
+        const auto& total = progress.score;
+        std::cout << "game " << game.index + 1 << " " << outcomeString(game.outcome) << " (" << game.reason << ", "
+                << game.moves.size() << " plies) - W: " << total.wins << " D: " << total.draws << " L: "
+                << total.losses;
+        if (progress.sprt) { std::cout << " " << progress.sprt->toString(); }
+        std::cout << std::endl;
+    });
+
+    std::cout << "Games: " << result.score.games() << " W: " << result.score.wins << " D: " << result.score.draws
+            << " L: " << result.score.losses << "\n"
+            << estimateElo(result.score).toString() << "\n"
+            << result.pentanomial.toString() << std::endl;
+    if (result.sprt) { std::cout << "SPRT: " << result.sprt->toString() << std::endl; }
+    return 0;
+}
@@ -0,0 +1,117 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <string_view>
+
+#include "BoardManager/BoardManager.h"
+#include "Engine/Perft.h"
+#include "Utility/Fen.h"
+#include "Utility/WorkStealingPool.h"
+
+namespace {
+    void printUsage(){
+        std::cerr << "usage: PerftCLI <depth> [--fen \"<fen>\"] [--threads <n>] [--hash <MB>] [--split <plies>]\n"
+                << "  --hash 0 turns the perft cache off\n";
+    }
+
+    bool isDigits(const std::string& text){
+        return !text.empty() && text.find_first_not_of("0123456789") == std::string::npos;
+    }
+
+    // setFullFen trusts its input, so anything off the command line is checked first - the trailing fields can be left off
+    bool isValidFen(const FenString& fen){
+        std::istringstream fields(fen);
+        std::string placement, side, castling, enPassant, halfMoves, fullMoves, extra;
+        fields >> placement >> side >> castling >> enPassant >> halfMoves >> fullMoves >> extra;
+        if (placement.empty() || !extra.empty()) { return false; }
+
+        int ranks = 1, files = 0, whiteKings = 0, blackKings = 0;
+        for (const char c: placement) {
+            if (c == '/') {
+                if (files != 8) { return false; }
+                ranks++;
+                files = 0;
+            } else if (c >= '1' && c <= '8') { files += c - '0'; } else if (std::string_view("PNBRQKpnbrqk").find(c) !=
+                                                                          std::string_view::npos) {
+                files++;
+                whiteKings += c == 'K';
+                blackKings += c == 'k';
+            } else { return false; }
+            if (files > 8) { return false; }
+        }
+        if (ranks != 8 || files != 8 || whiteKings != 1 || blackKings != 1) { return false; }
+
+        if (!side.empty() && side != "w" && side != "b") { return false; }
+        if (!castling.empty() && castling != "-" && castling.find_first_not_of("KQkq") != std::string::npos) {
+            return false;
+        }
+        if (!enPassant.empty() && enPassant != "-" && (enPassant.size() != 2 || enPassant[0] < 'a' || enPassant[0] > 'h'
+                                                       || (enPassant[1] != '3' && enPassant[1] != '6'))) {
+            return false;
+        }
+        if (!halfMoves.empty() && !isDigits(halfMoves)) { return false; }
+        if (!fullMoves.empty() && !isDigits(fullMoves)) { return false; }
+        return true;
+    }
+}
+
+int main(const int argc, char* argv[]){
+    if (argc < 2) {
+        printUsage();
+        return 1;
+    }
+
+    int depth = 0;
+    FenString fen = Fen::FULL_STARTING_FEN;
+    int threads = WorkStealingPool::defaultThreadCount();
+    size_t hashMB = 64;
+    int splitDepth = 2;
+
+    try {
+        depth = std::stoi(argv[1]);
+        for (int i = 2; i < argc; i++) {
+            const std::string_view option = argv[i];
+            if (i + 1 >= argc) {
+                printUsage();
+                return 1;
+            }
+            const std::string value = argv[++i];
+            if (option == "--fen") { fen = value; }
+            else if (option == "--threads") { threads = std::stoi(value); }
+            else if (option == "--hash") { hashMB = std::stoul(value); }
+            else if (option == "--split") { splitDepth = std::stoi(value); }
+            else {
+                printUsage();
+                return 1;
+            }
+        }
+    } catch (const std::exception&) {
+        printUsage();
+        return 1;
+    }
+
+    // stoi would take "-1" or "3x" without complaint
+    if (!isDigits(argv[1]) || !isValidFen(fen)) {
+        printUsage();
+        return 1;
+    }
+
+    BoardManager manager;
+    manager.setFullFen(fen);
+    const auto cache = hashMB > 0 ? std::make_unique<PerftCache>(hashMB) : nullptr;
+
+    const auto start = std::chrono::steady_clock::now();
+    const int64_t nodes = Perft::parallelCount(manager, depth, threads, cache.get(), splitDepth);
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "nodes " << nodes << "\n"
+            << "time " << static_cast<int64_t>(elapsed * 1000) << " ms\n"
+            << "nps " << static_cast<int64_t>(static_cast<double>(nodes) / elapsed) << std::endl;
+    return 0;
+}
@@ -0,0 +1,83 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "BoardManager/BoardManager.h"
+#include "Engine/Perft.h"
+#include "Utility/Fen.h"
+
+namespace {
+    struct BenchPosition {
+        std::string name;
+        FenString fen;
+        int depth;
+        int64_t expectedNodes;
+    };
+
+    // the standard chessprogramming.org perft positions, at depths that take a few seconds in total
+    const std::vector<BenchPosition> SUITE = {
+                {"startpos", Fen::FULL_STARTING_FEN, 5, 4865609},
+                {"kiwipete", Fen::FULL_KIWI_PETE_FEN, 4, 4085603},
+                {"position3", Fen::FULL_POSITION_3_FEN, 5, 674624},
+                {"position4", Fen::FULL_POSITION_4_FEN, 4, 422333},
+                {"position5", Fen::FULL_POSITION_5_FEN, 4, 2103487},
+                {"position6", Fen::FULL_POSITION_6_FEN, 4, 3894594},
+            };
+}
+
+// move generation regression gate - exits non-zero if any count is off
+int main(const int argc, char* argv[]){
+    int threads = 1;
+    if (argc == 3 && std::string_view(argv[1]) == "--threads") { threads = std::stoi(argv[2]); }
+    else if (argc != 1) {
+        std::cerr << "usage: perft_bench [--threads <n>]\n";
+        return 1;
+    }
+
+    std::cout << std::left << std::setw(12) << "position" << std::setw(7) << "depth" << std::setw(12) << "nodes"
+            << std::setw(10) << "ms" << "Mnps" << "\n";
+
+    int failures = 0;
+    int64_t totalNodes = 0;
+    double totalSeconds = 0;
+    for (const auto& [name, fen, depth, expectedNodes]: SUITE) {
+        BoardManager manager;
+        manager.setFullFen(fen);
+
+        const auto start = std::chrono::steady_clock::now();
+        const int64_t nodes = threads > 1
+                                  ? Perft::parallelCount(manager, depth, threads)
+                                  : Perft::count(manager, depth);
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        totalNodes += nodes;
+        totalSeconds += seconds;
+        std::cout << std::left << std::setw(12) << name << std::setw(7) << depth << std::setw(12) << nodes
+                << std::setw(10) << static_cast<int64_t>(seconds * 1000) << std::fixed << std::setprecision(2)
+                << static_cast<double>(nodes) / seconds / 1e6 << std::endl;
+
+        if (nodes != expectedNodes) {
+            std::cerr << "MISMATCH: " << name << " perft " << depth << " gave " << nodes << ", expected "
+                    << expectedNodes << "\n  " << fen << std::endl;
+            failures++;
+        }
+    }
+
+    std::cout << std::left << std::setw(12) << "total" << std::setw(7) << "" << std::setw(12) << totalNodes
+            << std::setw(10) << static_cast<int64_t>(totalSeconds * 1000) << std::fixed << std::setprecision(2)
+            << static_cast<double>(totalNodes) / totalSeconds / 1e6 << std::endl;
+
+    if (failures > 0) {
+        std::cerr << failures << " perft count(s) wrong" << std::endl;
+        return 1;
+    }
+    return 0;
+}
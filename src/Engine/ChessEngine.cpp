@@ -7,10 +7,10 @@
 #include <cmath>
 #include <future>
 
-#include "BoardManager/Referee.h"
 
 #include "Engine/Evaluation.h"
 #include "Engine/MoveGenerator.h"
+#include "Engine/Perft.h"
 
 int getPieceValue(Piece piece)
 {
@@ -74,44 +74,190 @@ void ChessEngine::SortMoves(std::vector<Move> &moves, const Move &ttMove)
                              });
 }
 
-ChessEngine::ChessEngine() : ChessPlayer(ENGINE),
-                             rng(std::chrono::system_clock::now().time_since_epoch().count())
+ChessEngine::ChessEngine() : ChessPlayer(ENGINE)
 {
-    auto path = std::filesystem::current_path();
-    std::string suffix = "";
-    suffix += rng() % 26 + 65;
-    path += "/searchLog" + suffix + ".txt";
-    searchLogStream = std::ofstream(path);
+    static std::atomic<int> instances = 0;
+    instanceID_ = instances++;
 
     evaluator_.setBoardManager(&internalBoardManager_);
 }
 
+void ChessEngine::logError(const std::string &error)
+{
+    if (!searchLogStream.is_open())
+    {
+        auto path = std::filesystem::current_path();
+        path += "/searchLog" + std::to_string(instanceID_) + ".txt";
+        searchLogStream.open(path);
+    }
+    searchLogStream << error << std::endl;
+}
+
 void ChessEngine::loadFEN(const std::string &fen) { boardManager()->setFullFen(fen); }
 
-void ChessEngine::go(const int depth)
+ChessEngine::~ChessEngine() { stop(); }
+
+void ChessEngine::stop()
 {
-    const auto bestMove = Search(depth).bestMove;
-    std::cout << "bestmove " << bestMove.toUCI() << std::endl;
+    {
+        std::lock_guard lock(searchStateMutex_);
+        stopSearch_ = true;
+    }
+    searchStateChanged_.notify_all();
+    if (searchThread_.joinable())
+    {
+        searchThread_.join();
+    }
+    stopSearch_ = false;
+    pondering_ = false;
 }
 
-void ChessEngine::go(const int depth, const int wtime, const int btime, const int winc, const int binc)
+void ChessEngine::ponderHit()
 {
-    const auto relevantTimeRemaining = internalBoardManager_.getCurrentTurn() == WHITE ? wtime : btime;
-    const auto relevantTimeIncrement = internalBoardManager_.getCurrentTurn() == WHITE ? winc : binc;
+    {
+        std::lock_guard lock(searchStateMutex_);
+        pondering_ = false;
+    }
+    searchStateChanged_.notify_all();
+}
 
-    const auto thisTimeBudget = relevantTimeRemaining / 20 + relevantTimeIncrement / 2;
+void ChessEngine::quit()
+{
+    stop();
+    shouldQuit_ = true;
+}
 
-    const auto bestMove = Search(depth, thisTimeBudget).bestMove;
-    if (bestMove.fileFrom == 0)
+void ChessEngine::respond(const std::string &message)
+{
+    uciWriter_.send(message);
+}
+
+void ChessEngine::startSearch(std::function<SearchResults()> search, const bool waitForStop)
+{
+    searching_ = true;
+    searchThread_ = std::thread([this, search = std::move(search), waitForStop]
+                                {
+                                    const auto result = search();
+
+                                    // infinite and ponder searches hold their answer until the GUI asks for it
+                                    std::unique_lock lock(searchStateMutex_);
+                                    searchStateChanged_.wait(lock, [this, waitForStop]
+                                                             { return stopSearch_ || (!waitForStop && !pondering_); });
+                                    lock.unlock();
+                                    reportBestMove(result);
+                                    searching_ = false;
+                                });
+}
+
+void ChessEngine::reportBestMove(const SearchResults &result)
+{
+    if (result.bestMove.fileFrom == 0)
     {
-        std::cout << "bestmove 0000";
+        respond("bestmove 0000");
     }
     else
     {
-        std::cout << "bestmove " << bestMove.toUCI() << std::endl;
+        std::string message = "bestmove " + result.bestMove.toUCI();
+        // our expected reply is what we'll think about on the opponent's time
+        if (result.variation.size() > 1)
+        {
+            message += " ponder " + result.variation[1].toUCI();
+        }
+        respond(message);
+    }
+}
+
+bool ChessEngine::pollStop()
+{
+    if (searchAborted_)
+    {
+        return true;
+    }
+
+    // node budgets are checked exactly so "go nodes" is reproducible
+    ++searchNodes_;
+    if (nodeLimit_ != 0 && searchNodes_ > nodeLimit_)
+    {
+        searchAborted_ = true;
+        return true;
+    }
+
+    // the stop flag and the clock are comparatively expensive, so only look at them every so often
+    if (++nodesSincePoll_ < STOP_POLL_INTERVAL)
+    {
+        return false;
+    }
+    nodesSincePoll_ = 0;
+    checkPonderHit();
+    searchAborted_ = stopSearch_.load(std::memory_order_relaxed)
+                     || (!ponderingSearch_ && std::chrono::steady_clock::now() >= deadline);
+    return searchAborted_;
+}
+
+void ChessEngine::checkPonderHit()
+{
+    if (ponderingSearch_ && !pondering_.load(std::memory_order_relaxed))
+    {
+        // the opponent played the expected move, so our own clock starts now
+        ponderingSearch_ = false;
+        timeManager_.restart();
+        deadline = timeManager_.hardDeadline();
     }
 }
 
+void ChessEngine::beginSearch(const std::chrono::steady_clock::time_point searchDeadline, const uint64_t nodeLimit)
+{
+    deadline = searchDeadline;
+    nodeLimit_ = nodeLimit;
+    searchNodes_ = 0;
+    searchStart_ = std::chrono::steady_clock::now();
+    nodesSincePoll_ = 0;
+    searchAborted_ = false;
+}
+
+void ChessEngine::go(const SearchLimits &limits)
+{
+    // infinite searches hold their answer until the GUI asks for it
+    stop(); // only ever one search in flight
+    pondering_ = limits.ponder;
+    startSearch([this, limits] { return Search(limits); }, limits.infinite);
+}
+
+void ChessEngine::setPosition(const std::string &fen, const std::vector<std::string> &moves)
+{
+    // the board must still be exactly where the last position command left it,
+    // otherwise someone has moved it (setFullFen, a test, the GUI) and we replay from scratch
+    const bool continuesGame = !positionFen_.empty()
+                               && fen == positionFen_
+                               && moves.size() >= positionMoves_.size()
+                               && std::equal(positionMoves_.begin(), positionMoves_.end(), moves.begin())
+                               && internalBoardManager_.getZobristHash()->getHash() == positionHash_;
+
+    size_t firstNewMove = positionMoves_.size();
+    if (!continuesGame)
+    {
+        internalBoardManager_.resetGame();
+        internalBoardManager_.setFullFen(fen);
+        positionFen_ = fen;
+        positionMoves_.clear();
+        firstNewMove = 0;
+    }
+
+    for (size_t i = firstNewMove; i < moves.size(); i++)
+    {
+        if (!internalBoardManager_.tryMove(moves[i]))
+        {
+            logError("Invalid move: " + moves[i] + "\n");
+            // the board and the GUI disagree now, so don't trust this as a base next time
+            positionFen_.clear();
+            return;
+        }
+        positionMoves_.push_back(moves[i]);
+    }
+
+    positionHash_ = internalBoardManager_.getZobristHash()->getHash();
+}
+
 void ChessEngine::parseUCI(const std::string &uci)
 {
     auto command = parser.parse(uci);
@@ -136,42 +282,94 @@ bool ChessEngine::sendCommand(const std::string &command)
 
 std::string ChessEngine::readResponse() { return ""; }
 
-SearchResults ChessEngine::executeSearch(const int depth, const bool timed)
+void ChessEngine::initialiseRootMoves()
+{
+    rootMoves_.clear();
+    for (const auto &move : MoveGenerator::getMoves(internalBoardManager_))
+    {
+        rootMoves_.push_back(RootMove{.move = move});
+    }
+}
+
+SearchResults ChessEngine::executeSearch(const int depth)
 {
     SearchResults bestResult;
-    auto moves = MoveGenerator::getMoves(internalBoardManager_);
-    if (moves.empty())
+    if (rootMoves_.empty())
     {
         return bestResult;
     }
 
-    bestResult.bestMove = moves[0];
-    bestResult.score = -MATE_SCORE - 1;
-
-    float alpha = -INFINITY;
-    float beta = INFINITY;
+    // last iteration's best move goes first, so it sets alpha for the others
+    for (auto &rootMove : rootMoves_)
+    {
+        rootMove.previousScore = rootMove.score;
+        rootMove.score = -MATE_SCORE - 1;
+    }
+    std::ranges::stable_sort(rootMoves_, std::ranges::greater{}, &RootMove::previousScore);
+    currentSearchStats.selDepth = 0;
 
-    for (auto &move : moves)
+    // one full-window pass per line; each pass skips the moves earlier passes already settled,
+    // so only the first multiPV_ root moves ever get exact scores
+    const size_t lines = std::min(static_cast<size_t>(multiPV_), rootMoves_.size());
+    for (size_t pvIndex = 0; pvIndex < lines && !searchAborted_; pvIndex++)
     {
-        internalBoardManager_.forceMove(move);
+        float alpha = -INFINITY;
+        float beta = INFINITY;
 
-        std::vector<Move> thisPV;
-        float eval = -alphaBeta(depth - 1, alpha, beta, 1, thisPV, timed);
-        lastSearchEvaluations.moves.push_back(move);
-        lastSearchEvaluations.scores.push_back(eval);
+        for (auto rootMove = rootMoves_.begin() + pvIndex; rootMove != rootMoves_.end(); ++rootMove)
+        {
+            if (elapsedSearchMs() >= CURRMOVE_REPORT_DELAY_MS)
+            {
+                const auto moveNumber = std::distance(rootMoves_.begin(), rootMove) + 1;
+                respond("info depth " + std::to_string(depth) + " currmove " + rootMove->move.toUCI()
+                        + " currmovenumber " + std::to_string(moveNumber));
+            }
 
-        internalBoardManager_.undoMove();
+            const int nodesBefore = currentSearchStats.nodesSearched;
+            internalBoardManager_.forceMove(rootMove->move);
+            float eval = -alphaBeta(depth - 1, -beta, -alpha, 1);
+            internalBoardManager_.undoMove();
 
-        if (eval > bestResult.score)
-        {
-            bestResult.score = eval;
-            bestResult.bestMove = move;
+            // an aborted child's score is meaningless, keep what we had
+            if (searchAborted_)
+            {
+                break;
+            }
+
+            rootMove->score = eval;
+            rootMove->nodes += currentSearchStats.nodesSearched - nodesBefore;
+            pvTable_.update(0, rootMove->move);
+            rootMove->pv = pvTable_.line(0);
 
-            bestResult.variation.clear();
-            bestResult.variation.push_back(move);
-            bestResult.variation.insert(bestResult.variation.end(),
-                                        thisPV.begin(), thisPV.end());
+            if (eval > alpha)
+            {
+                // a new best line mid-iteration is worth telling the GUI about straight away
+                if (pvIndex == 0 && alpha != -INFINITY)
+                {
+                    respond(infoLine(depth, pvIndex, *rootMove));
+                }
+                alpha = eval;
+            }
         }
+        if (searchAborted_)
+        {
+            break;
+        }
+
+        // this pass's best becomes line pvIndex + 1, the rest are ordered for the next pass
+        std::stable_sort(rootMoves_.begin() + pvIndex, rootMoves_.end(),
+                         [](const RootMove &a, const RootMove &b) { return a.score > b.score; });
+    }
+
+    bestResult.bestMove = rootMoves_[0].move;
+    bestResult.score = rootMoves_[0].score;
+    bestResult.variation = rootMoves_[0].pv;
+
+    lastSearchEvaluations.reset();
+    for (const auto &rootMove : rootMoves_)
+    {
+        lastSearchEvaluations.moves.push_back(rootMove.move);
+        lastSearchEvaluations.scores.push_back(rootMove.score);
     }
 
     currentSearchStats.depth = depth;
@@ -181,29 +379,73 @@ SearchResults ChessEngine::executeSearch(const int depth, const bool timed)
 
 SearchResults ChessEngine::Search(const int depth)
 {
-    lastSearchEvaluations.reset();
     currentSearchStats.searchID++;
-    ;
+    beginSearch(std::chrono::steady_clock::time_point::max());
+    initialiseRootMoves();
     return executeSearch(depth);
 }
 
-SearchResults ChessEngine::Search(int MaxDepth, int SearchMs)
+SearchResults ChessEngine::Search(const int MaxDepth, const int SearchMs)
+{
+    return Search(SearchLimits{.depth = MaxDepth, .movetime = SearchMs});
+}
+
+SearchResults ChessEngine::SearchNodes(const int MaxDepth, const uint64_t nodeBudget)
+{
+    return Search(SearchLimits{.depth = MaxDepth, .nodes = nodeBudget});
+}
+
+SearchResults ChessEngine::Search(const SearchLimits &limits)
 {
     currentSearchStats.searchID++;
-    const int marginSearch = std::max(50, SearchMs - 50);
-    deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(marginSearch);
+    timeManager_.init(limits, internalBoardManager_.getCurrentTurn());
+    beginSearch(timeManager_.hardDeadline(), limits.nodes.value_or(0));
+    ponderingSearch_ = limits.ponder;
+
+    return iterativeDeepening(limits.depth.value_or(MAX_SEARCH_PLY - 1));
+}
 
+SearchResults ChessEngine::iterativeDeepening(const int maxDepth)
+{
     SearchResults bestResult;
     int maxDepthReached = 0;
 
-    for (int depth = 1; depth <= MaxDepth; depth++)
+    initialiseRootMoves();
+    for (int depth = 1; depth <= maxDepth; depth++)
     {
-        if (std::chrono::steady_clock::now() >= deadline)
+        // a stopped iteration is incomplete, so only the last finished one counts
+        auto iterationResult = executeSearch(depth);
+        if (searchAborted_)
         {
             break;
         }
-        bestResult = executeSearch(depth, true);
+        const bool bestMoveChanged = maxDepthReached > 0 && !(iterationResult.bestMove == bestResult.bestMove);
+        bestResult = iterationResult;
         maxDepthReached = depth;
+        reportLines(depth);
+
+        uint64_t totalNodes = 0;
+        uint64_t bestMoveNodes = 0;
+        for (const auto &rootMove : rootMoves_)
+        {
+            totalNodes += rootMove.nodes;
+            if (rootMove.move == bestResult.bestMove)
+            {
+                bestMoveNodes = rootMove.nodes;
+            }
+        }
+        timeManager_.updateIteration(bestMoveChanged, bestResult.score, bestMoveNodes, totalNodes);
+        checkPonderHit();
+        if (!ponderingSearch_ && timeManager_.shouldStop())
+        {
+            break;
+        }
+    }
+
+    // stopped before even depth 1 finished - anything legal beats no move
+    if (maxDepthReached == 0 && !rootMoves_.empty())
+    {
+        bestResult.bestMove = rootMoves_[0].move;
     }
 
     currentSearchStats.depth = maxDepthReached;
@@ -212,35 +454,127 @@ SearchResults ChessEngine::Search(int MaxDepth, int SearchMs)
     return bestResult;
 }
 
-std::optional<float> ChessEngine::evaluateGameState(const int depth, const int ply, const int boardStatus)
+void ChessEngine::reportLines(const int depth)
 {
-    if (boardStatus & BoardStatus::BLACK_CHECKMATE || boardStatus & WHITE_CHECKMATE)
+    // one flush for the whole batch of lines
+    const size_t lines = std::min(static_cast<size_t>(multiPV_), rootMoves_.size());
+    for (size_t pvIndex = 0; pvIndex < lines; pvIndex++)
     {
-        currentSearchStats.endGameExits++;
-        return -MATE_SCORE + ply;
+        uciWriter_.line(infoLine(depth, pvIndex, rootMoves_[pvIndex]));
+    }
+    uciWriter_.flush();
+}
+
+std::string ChessEngine::infoLine(const int depth, const size_t pvIndex, const RootMove &rootMove)
+{
+    const int elapsed = elapsedSearchMs();
+    const uint64_t nps = searchNodes_ * 1000 / std::max(1, elapsed);
+
+    std::string message = "info depth " + std::to_string(depth)
+                          + " seldepth " + std::to_string(std::max(depth, currentSearchStats.selDepth))
+                          + " multipv " + std::to_string(pvIndex + 1)
+                          + " score " + formatUciScore(rootMove.score)
+                          + " nodes " + std::to_string(searchNodes_)
+                          + " nps " + std::to_string(nps)
+                          + " hashfull " + std::to_string(transpositionTable_.hashfull())
+                          + " time " + std::to_string(elapsed)
+                          + " pv";
+    for (const auto &move : rootMove.pv)
+    {
+        message += " " + move.toUCI();
     }
+    return message;
+}
+
+int ChessEngine::elapsedSearchMs() const
+{
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - searchStart_).count());
+}
 
-    if (internalBoardManager_.getGameResult() & GameResult::DRAW)
+float ChessEngine::quiescence(float alpha, const float beta, const int ply)
+{
+    currentSearchStats.quiescenceNodes++;
+    currentSearchStats.selDepth = std::max(currentSearchStats.selDepth, ply);
+    if (pollStop())
     {
         return 0.0f;
     }
-    if (depth == 0)
+
+    // stand pat - the side to move can always decline the remaining captures
+    const float standPat = evaluator_.evaluate();
+    if (standPat >= beta)
+    {
+        return standPat;
+    }
+    if (standPat > alpha)
     {
-        return evaluator_.evaluate();
+        alpha = standPat;
+    }
+
+    auto moves = MoveGenerator::getMoves(internalBoardManager_);
+    SortMoves(moves, Move{});
+
+    for (auto &move : moves)
+    {
+        if (!(move.resultBits & MoveResult::CAPTURE))
+        {
+            continue;
+        }
+
+        internalBoardManager_.forceMove(move);
+        const float eval = -quiescence(-beta, -alpha, ply + 1);
+        internalBoardManager_.undoMove();
+
+        if (eval >= beta)
+        {
+            return eval;
+        }
+        if (eval > alpha)
+        {
+            alpha = eval;
+        }
     }
-    return std::nullopt;
+
+    return alpha;
 }
 
-bool ChessEngine::performNullMoveReduction(const int depth, const float beta, const int ply, const bool timed,
-                                           float &evaluatedValue)
+bool ChessEngine::performStaticPruning(const int depth, const float alpha, const float beta, const int ply,
+                                       const float staticEval, float &evaluatedValue)
+{
+    // reverse futility (static null move) - we're so far above beta that a quiet move won't bring us back down
+    if (std::abs(beta) < MATE_SCORE - MAX_SEARCH_PLY
+        && staticEval - pruningMargins_.reverseFutility[depth] >= beta)
+    {
+        currentSearchStats.reverseFutilityPrunes++;
+        evaluatedValue = staticEval - pruningMargins_.reverseFutility[depth];
+        return true;
+    }
+
+    // razoring - so far below alpha that only captures can save us, so let quiescence decide
+    if (std::abs(alpha) < MATE_SCORE - MAX_SEARCH_PLY
+        && staticEval + pruningMargins_.razoring[depth] < alpha)
+    {
+        const float quiescenceScore = quiescence(alpha, beta, ply);
+        if (depth == 1 || quiescenceScore < alpha)
+        {
+            currentSearchStats.razorPrunes++;
+            evaluatedValue = quiescenceScore;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+bool ChessEngine::performNullMoveReduction(const int depth, const float beta, const int ply, float &evaluatedValue)
 {
     const int reduction = 3;
     internalBoardManager_.makeNullMove();
 
-    std::vector<Move> nullPV;
     float nullScore = -alphaBeta(depth - reduction, -beta, -beta + 1,
-                                 ply + 1, nullPV, timed, false); // Don't allow nested nulls
-    internalBoardManager_.makeNullMove();
+                                 ply + 1, false); // Don't allow nested nulls
+    internalBoardManager_.undoNullMove();
 
     if (nullScore >= beta)
     {
@@ -252,13 +586,20 @@ bool ChessEngine::performNullMoveReduction(const int depth, const float beta, co
     return false;
 }
 
-bool ChessEngine::getTranspositionTableValue(const int depth, Move &ttMove, float &evalResult)
+bool ChessEngine::getTranspositionTableValue(const int depth, const float alpha, const float beta, Move &ttMove,
+                                             float &evalResult)
 {
     auto hash = boardManager()->getZobristHash()->getHash();
     auto ttEntry = transpositionTable_.retrieveVector(hash);
     currentSearchStats.ttProbes++;
 
-    if (ttEntry.has_value() && ttEntry->depth >= depth)
+    // a bound only answers the question if it's on the right side of this window
+    const bool usable = ttEntry.has_value()
+                        && (ttEntry->bound == TTBound::EXACT
+                            || (ttEntry->bound == TTBound::LOWER && ttEntry->eval >= beta)
+                            || (ttEntry->bound == TTBound::UPPER && ttEntry->eval <= alpha));
+
+    if (usable && ttEntry->depth >= depth)
     {
         currentSearchStats.ttCutoffs++;
 
@@ -277,45 +618,54 @@ bool ChessEngine::getTranspositionTableValue(const int depth, Move &ttMove, floa
     return false;
 }
 
-void ChessEngine::storeTranspositionTableEntry(const int depth, float bestScore, Move bestMove)
+void ChessEngine::storeTranspositionTableEntry(const int depth, float bestScore, Move bestMove, const TTBound bound)
 {
     TTEntry newEntry{
         .key = boardManager()->getZobristHash()->getHash(),
         .eval = bestScore,
         .bestMove = bestMove,
         .depth = depth,
-        .age = currentSearchStats.searchID // Track which search this is from
+        .age = currentSearchStats.searchID, // Track which search this is from
+        .bound = bound
     };
     transpositionTable_.storeVector(newEntry);
     currentSearchStats.ttStores++;
 }
 
 float ChessEngine::performSearchLoop(std::vector<Move> &moves, const int depth, float alpha, const float beta,
-                                     const int ply, const bool timed, std::vector<Move> &pv)
+                                     const int ply, const bool futilityPruning)
 {
+    const float originalAlpha = alpha;
     float bestScore = -MATE_SCORE - 1;
     Move bestMove;
-    std::vector<Move> bestPV;
 
     bool isFirstMove = true;
     for (auto &move : moves)
     {
-        if (timed && std::chrono::steady_clock::now() >= deadline)
+        // futility pruning - quiet moves can't lift a hopeless static eval up to alpha, so don't search them
+        if (futilityPruning && !isFirstMove
+            && !(move.resultBits & (MoveResult::CAPTURE | MoveResult::PROMOTION | MoveResult::CHECK)))
         {
-            return 0.0f; // bail inside loop
+            currentSearchStats.futilityPrunes++;
+            continue;
         }
 
         // push the move onto the board
         internalBoardManager_.forceMove(move);
-        std::vector<Move> thisPV;
-        float eval = -alphaBeta(depth - 1, -beta, -alpha, ply + 1, thisPV, timed, true);
+        float eval = -alphaBeta(depth - 1, -beta, -alpha, ply + 1, true);
         internalBoardManager_.undoMove();
 
+        // unwind without touching the TT, the parent throws this node away
+        if (searchAborted_)
+        {
+            return 0.0f;
+        }
+
         if (eval > bestScore)
         {
             bestScore = eval;
             bestMove = move;
-            bestPV = thisPV;
+            pvTable_.update(ply, move);
         }
 
         if (eval > alpha)
@@ -334,46 +684,80 @@ float ChessEngine::performSearchLoop(std::vector<Move> &moves, const int depth,
         }
         isFirstMove = false;
     }
-    storeTranspositionTableEntry(depth, bestScore, bestMove);
-
-    if (bestScore > -MATE_SCORE - 1)
+    TTBound bound = TTBound::EXACT;
+    if (bestScore >= beta)
     {
-        pv.push_back(bestMove);
-        pv.insert(pv.end(), bestPV.begin(), bestPV.end());
+        bound = TTBound::LOWER;
     }
+    else if (bestScore <= originalAlpha)
+    {
+        bound = TTBound::UPPER;
+    }
+    storeTranspositionTableEntry(depth, bestScore, bestMove, bound);
 
     return bestScore;
 }
 
-float ChessEngine::alphaBeta(const int depth, float alpha, const float beta, const int ply, std::vector<Move> &pv,
-                             const bool timed, const bool nullMoveAllowed)
+float ChessEngine::alphaBeta(const int depth, float alpha, const float beta, const int ply,
+                             const bool nullMoveAllowed)
 {
-    pv.clear();
+    pvTable_.clear(ply);
+    currentSearchStats.selDepth = std::max(currentSearchStats.selDepth, ply);
+    if (pollStop())
+    {
+        return 0.0f;
+    }
+    if (ply >= MAX_SEARCH_PLY - 1)
+    {
+        return evaluator_.evaluate();
+    }
 
-    // if the game is over, or bottom depth - exit now
-    const auto status = Referee::checkBoardStatus(
-        *internalBoardManager_.getBitboards(),
-        *internalBoardManager_.getMagicBitBoards(),
-        internalBoardManager_.getCurrentTurn());
+    // going back to a position we've already been through is a draw - no need to look any further
+    if (internalBoardManager_.isRepetition(ply))
+    {
+        currentSearchStats.endGameExits++;
+        return 0.0f;
+    }
+
+    const bool inCheck = internalBoardManager_.isInCheck();
 
-    if (auto endGameEvaluation = evaluateGameState(depth, ply, status);
-        endGameEvaluation.has_value())
+    // bottom depth - only a position in check needs its moves looking at, to tell mate apart from check
+    if (depth <= 0)
     {
-        return endGameEvaluation.value();
+        if (inCheck && !internalBoardManager_.hasAnyLegalMoves())
+        {
+            currentSearchStats.endGameExits++;
+            return -MATE_SCORE + ply;
+        }
+        return internalBoardManager_.isFiftyMoveDraw() ? 0.0f : evaluator_.evaluate();
     }
 
     // query the transposition table
     Move ttMove;
-    if (float evalResult; getTranspositionTableValue(depth, ttMove, evalResult))
+    if (float evalResult; getTranspositionTableValue(depth, alpha, beta, ttMove, evalResult))
     {
         return evalResult;
     }
 
+    // static eval based pruning near the leaves
+    bool futilityPruning = false;
+    if (pruningMargins_.enabled && depth <= PruningMargins::MAX_PRUNING_DEPTH && !inCheck)
+    {
+        const float staticEval = evaluator_.evaluate();
+        if (float evaluatedValue; performStaticPruning(depth, alpha, beta, ply, staticEval, evaluatedValue))
+        {
+            return evaluatedValue;
+        }
+
+        futilityPruning = std::abs(alpha) < MATE_SCORE - MAX_SEARCH_PLY
+                          && staticEval + pruningMargins_.futility[depth] <= alpha;
+    }
+
     // null move reductions
-    if (nullMoveAllowed && depth >= 3 && !(status & (BoardStatus::BLACK_CHECK | BoardStatus::WHITE_CHECK)))
+    if (nullMoveAllowed && depth >= 3 && !inCheck)
     {
         float evaluatedValue;
-        if (performNullMoveReduction(depth, beta, ply, timed, evaluatedValue))
+        if (performNullMoveReduction(depth, beta, ply, evaluatedValue))
         {
             return evaluatedValue;
         }
@@ -382,148 +766,77 @@ float ChessEngine::alphaBeta(const int depth, float alpha, const float beta, con
     auto moves = MoveGenerator::getMoves(internalBoardManager_);
     SortMoves(moves, ttMove);
 
+    // no legal moves is the end of the game - mate if we're in check, stalemate if not
     if (moves.empty())
     {
         currentSearchStats.endGameExits++;
-        return evaluator_.evaluate();
+        return inCheck ? -MATE_SCORE + ply : 0.0f;
+    }
+
+    if (internalBoardManager_.isFiftyMoveDraw())
+    {
+        return 0.0f;
     }
 
     currentSearchStats.nodesSearched++;
-    return performSearchLoop(moves, depth, alpha, beta, ply, timed, pv);
+    return performSearchLoop(moves, depth, alpha, beta, ply, futilityPruning);
 }
 
-PerftResults ChessEngine::perft(const int depth)
-{
-    if (depth == 0)
-        return PerftResults{1, 0, 0, 0, 0, 0};
+PerftResults ChessEngine::perft(const int depth) { return Perft::run(internalBoardManager_, depth); }
 
-    PerftResults result{0, 0, 0, 0, 0, 0};
-    auto moves = MoveGenerator::getMoves(internalBoardManager_);
+std::vector<PerftResults> ChessEngine::perftDivide(const int depth) { return Perft::divide(internalBoardManager_, depth); }
 
-    for (auto &move : moves)
-    {
-        // moves should be checked for legality already at this point so don't even worry
-        internalBoardManager_.forceMove(move);
-        const PerftResults child = perft(depth - 1);
+int64_t ChessEngine::simplePerft(const int depth) { return Perft::count(internalBoardManager_, depth); }
 
-        if (depth == 1)
-        {
-            result.nodes++;
-            // Only increment move result types at leaf depth
-            if (move.resultBits & CHECK)
-            {
-                result.checks++;
-            }
-            if (move.resultBits & EN_PASSANT)
-            {
-                result.enPassant++;
-            }
-            if (move.resultBits & CAPTURE)
-            {
-                result.captures++;
-            }
-            if (move.resultBits & CASTLING)
-            {
-                result.castling++;
-            }
-            if (move.resultBits & CHECK_MATE)
-            {
-                result.checkMate++;
-            }
-            if (move.resultBits & PROMOTION)
-            {
-                // spacing comment
-                result.promotions++;
-            }
-        }
-        else
-        {
-            result += child;
-        }
-
-        internalBoardManager_.undoMove();
-    }
-    return result;
+PerftResults ChessEngine::runPerftTest(const std::string &Fen, const int depth)
+{
+    internalBoardManager_.setFullFen(Fen);
+    return perft(depth);
 }
 
-std::vector<PerftResults> ChessEngine::perftDivide(const int depth)
+std::vector<PerftResults> ChessEngine::runDivideTest(const std::string &Fen, const int depth)
 {
-    auto moves = MoveGenerator::getMoves(internalBoardManager_);
-    std::vector<PerftResults> results;
-
-    for (auto &move : moves)
-    {
-        auto result = PerftResults();
-        result.fen = move.toUCI();
-        internalBoardManager_.forceMove(move);
-
-        if (depth == 1)
-        {
-            result.nodes = 1;
-            if (move.resultBits & CHECK)
-            {
-                result.checks++;
-            }
-            if (move.resultBits & EN_PASSANT)
-            {
-                result.enPassant++;
-            }
-            if (move.resultBits & CAPTURE)
-            {
-                result.captures++;
-            }
-            if (move.resultBits & CASTLING)
-            {
-                result.castling++;
-            }
-            if (move.resultBits & CHECK_MATE)
-            {
-                result.checkMate++;
-            }
-            if (move.resultBits & PROMOTION)
-            {
-                result.promotions++;
-            }
-        }
-        else
-        {
-            result += perft(depth - 1);
-        }
+    internalBoardManager_.setFullFen(Fen);
+    return perftDivide(depth);
+}
 
-        internalBoardManager_.undoMove();
-        results.push_back(result);
-    }
+std::vector<PerftResults> ChessEngine::runDivideTest(const int depth) { return perftDivide(depth); }
 
-    return results;
+PerftResults ChessEngine::runParallelPerftTest(const std::string &Fen, const int depth, const int threads,
+                                               const int splitDepth)
+{
+    internalBoardManager_.setFullFen(Fen);
+    return Perft::parallel(internalBoardManager_, depth, threads, splitDepth);
 }
 
-int ChessEngine::simplePerft(const int depth)
+BenchResult ChessEngine::bench(const int depth)
 {
-    if (depth == 0)
-        return 1;
+    stop();
+    BenchResult result;
+    // only the searches are timed - clearing the table in reset() costs more the bigger it is, not the slower the search
+    std::chrono::steady_clock::duration searching{};
 
-    int nodes = 0;
-    auto moves = MoveGenerator::getMoves(internalBoardManager_);
-    for (Move &move : moves)
+    for (size_t i = 0; i < Bench::POSITIONS.size(); i++)
     {
-        internalBoardManager_.forceMove(move);
-        nodes += simplePerft(depth - 1);
-        internalBoardManager_.undoMove();
+        // nothing may carry over from the last position, or the node count stops being a signature
+        reset();
+        const std::string fen(Bench::POSITIONS[i]);
+        internalBoardManager_.setFullFen(fen);
+        uciWriter_.line("Position: " + std::to_string(i + 1) + "/" + std::to_string(Bench::POSITIONS.size())
+                        + " (" + fen + ")");
+
+        const auto start = std::chrono::steady_clock::now();
+        Search(SearchLimits{.depth = depth});
+        searching += std::chrono::steady_clock::now() - start;
+        result.nodes += searchNodes_;
     }
 
-    return nodes;
-}
-
-PerftResults ChessEngine::runPerftTest(const std::string &Fen, const int depth)
-{
-    internalBoardManager_.getBitboards()->setFenPositionOnly(Fen);
-    return perft(depth);
-}
+    result.elapsedMs = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(searching).count());
+    reset();
 
-std::vector<PerftResults> ChessEngine::runDivideTest(const std::string &Fen, const int depth)
-{
-    internalBoardManager_.getBitboards()->setFenPositionOnly(Fen);
-    return perftDivide(depth);
+    uciWriter_.line("===========================");
+    uciWriter_.line("Total time (ms) : " + std::to_string(result.elapsedMs));
+    uciWriter_.line("Nodes searched  : " + std::to_string(result.nodes));
+    uciWriter_.send("Nodes/second    : " + std::to_string(result.nps()));
+    return result;
 }
-
-std::vector<PerftResults> ChessEngine::runDivideTest(const int depth) { return perftDivide(depth); }
\ No newline at end of file
@@ -4,4 +4,14 @@
 
 #include "../../include/Engine/ChessPlayer.h"
 
-ChessPlayer::ChessPlayer(const PlayerType playerType) : playerType(playerType){}
\ No newline at end of file
+#include <chrono>
+#include <thread>
+
+ChessPlayer::ChessPlayer(const PlayerType playerType) : playerType(playerType){}
+
+std::string ChessPlayer::waitForResponse(const int timeoutMs){
+    // nothing to block on here, so just back off a little before the caller asks again
+    std::string response = readResponse();
+    if (response.empty() && timeoutMs > 0) { std::this_thread::sleep_for(std::chrono::milliseconds(1)); }
+    return response;
+}
\ No newline at end of file
@@ -3,48 +3,85 @@
 //
 
 #include "../../include/Engine/CommandHandlerBase.h"
+#include "Engine/Bench.h"
 #include "Engine/ChessEngine.h"
 
+#include <cctype>
+
 void CommandHandlerBase::operator()(const UCICommand& cmd, ChessEngine* engine){
-    std::cout << "uciok" << std::endl;
-    std::cout << "id " << engine->engineID() << std::endl;
+    engine->respond("option name MultiPV type spin default 1 min 1 max " + std::to_string(ChessEngine::MAX_MULTI_PV));
+    engine->respond("uciok");
+    engine->respond("id " + engine->engineID());
 }
 
 void CommandHandlerBase::operator()(const StopCommand& cmd, ChessEngine* engine){ engine->stop(); }
 
 void CommandHandlerBase::operator()(const IsReadyCommand& cmd, ChessEngine* engine){
-    std::cout << "readyok" << std::endl;
+    // answered straight away, even mid-search
+    engine->respond("readyok");
 }
 
+void CommandHandlerBase::operator()(const PonderHitCommand& cmd, ChessEngine* engine){ engine->ponderHit(); }
+
 void CommandHandlerBase::operator()(const QuitCommand& cmd, ChessEngine* engine){
     // space handler
     engine->quit();
 }
 
 void CommandHandlerBase::operator()(const GoCommand& cmd, ChessEngine* engine){
-    const auto depth = cmd.depth.value_or(engine->getSearchDepth());
-    const auto hasTimeCommands = cmd.wtime.has_value() && cmd.btime.has_value();
+    SearchLimits limits;
+    limits.depth = cmd.depth;
+    limits.wtime = cmd.wtime;
+    limits.btime = cmd.btime;
+    limits.winc = cmd.winc;
+    limits.binc = cmd.binc;
+    limits.movestogo = cmd.movestogo;
+    limits.movetime = cmd.movetime;
+    limits.nodes = cmd.nodes;
+    limits.infinite = cmd.infinite;
+    limits.ponder = cmd.ponder;
 
-    if (hasTimeCommands) { engine->go(depth, cmd.wtime.value(), cmd.btime.value()); } else { engine->go(depth); }
+    // a bare "go" has nothing to stop it, so fall back to the configured depth
+    const bool unbounded = !limits.hasClock() && !limits.movetime && !limits.nodes && !limits.infinite
+                           && !limits.ponder;
+    if (unbounded && !limits.depth.has_value()) { limits.depth = engine->getSearchDepth(); }
+
+    engine->go(limits);
 }
 
 void CommandHandlerBase::operator()(const PositionCommand& cmd, ChessEngine* engine){
-    engine->reset();
-    engine->boardManager()->setFullFen(cmd.fen);
-    for (auto& move: cmd.moves) {
-        if (const bool result = engine->boardManager()->tryMove(move); !result) {
-            engine->logError("Invalid move: " + move + "\n");
-        }
-    }
+    engine->stop(); // never move the board out from under a running search
+    // the TT survives between moves of a game, only ucinewgame clears it
+    engine->setPosition(cmd.fen, cmd.moves);
 }
 
 void CommandHandlerBase::operator()(const BestMoveCommand& cmd, ChessEngine* engine){}
 
-void CommandHandlerBase::operator()(const NewGameCommand& cmd, ChessEngine* engine){ engine->reset(); }
+void CommandHandlerBase::operator()(const NewGameCommand& cmd, ChessEngine* engine){
+    engine->stop();
+    engine->reset();
+}
 
 void CommandHandlerBase::operator()(const IDCommand& cmd, ChessEngine* engine){ return; }
 
 void CommandHandlerBase::operator()(const SetIDCommand& cmd, ChessEngine* engine){
     // spacing comment for breakpoint
     engine->setEngineID(cmd.id);
-}
\ No newline at end of file
+}
+
+void CommandHandlerBase::operator()(const SetOptionCommand& cmd, ChessEngine* engine){
+    // option names are case-insensitive in UCI
+    std::string name = cmd.name;
+    std::ranges::transform(name, name.begin(), [](const unsigned char c) { return std::tolower(c); });
+
+    if (name == "multipv" && Tokeniser::isIntLiteral(cmd.value) && !cmd.value.empty()) {
+        engine->setMultiPV(std::stoi(cmd.value));
+        return;
+    }
+    engine->logError("Unknown option: " + cmd.name + "\n");
+}
+
+void CommandHandlerBase::operator()(const BenchCommand& cmd, ChessEngine* engine){
+    engine->stop();
+    engine->bench(cmd.depth.value_or(Bench::DEFAULT_DEPTH));
+}
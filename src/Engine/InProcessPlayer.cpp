@@ -0,0 +1,21 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include "Engine/InProcessPlayer.h"
+
+InProcessPlayer::InProcessPlayer(std::unique_ptr<ChessEngine> engine) : engine_(std::move(engine)){
+    // nobody is reading stdout for this engine
+    engine_->setOutputMuted(true);
+}
+
+void InProcessPlayer::newGame(const FenString& fen){
+    engine_->reset();
+    engine_->setFullFen(fen);
+}
+
+void InProcessPlayer::play(const Move& move){
+    // a copy, since making the move writes the outcome back into it
+    Move played = move;
+    engine_->boardManager()->forceMove(played);
+}
@@ -34,7 +34,8 @@ void MoveGenerator::generateValidMovesFromPosition(const Piece piece, const int
     auto possibleMoves = manager.getMagicBitBoards()->getMoves(
         startSquare,
         piece,
-        *manager.getBitboards()
+        *manager.getBitboards(),
+        manager.getCastlingRights()
     );
 
     while (possibleMoves) {
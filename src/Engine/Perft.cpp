@@ -0,0 +1,152 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include "Engine/Perft.h"
+
+#include <algorithm>
+
+#include "Engine/MoveGenerator.h"
+#include "Utility/WorkStealingPool.h"
+
+PerftResults Perft::run(BoardManager& manager, const int depth){
+    if (depth == 0) { return PerftResults{.nodes = 1}; }
+
+    PerftResults result;
+    auto moves = MoveGenerator::getMoves(manager);
+
+    // bulk count: the generator has already checked legality and set the result bits,
+    // so the last ply never needs making
+    if (depth == 1) {
+        for (const auto& move: moves) { tallyLeaf(move, result); }
+        return result;
+    }
+
+    for (auto& move: moves) {
+        manager.forceMove(move);
+        result += run(manager, depth - 1);
+        manager.undoMove();
+    }
+    return result;
+}
+
+std::vector<PerftResults> Perft::divide(BoardManager& manager, const int depth){
+    auto moves = MoveGenerator::getMoves(manager);
+    std::vector<PerftResults> results;
+    results.reserve(moves.size());
+
+    for (auto& move: moves) {
+        auto result = PerftResults();
+        result.fen = move.toUCI();
+        if (depth == 1) { tallyLeaf(move, result); } else {
+            manager.forceMove(move);
+            result += run(manager, depth - 1);
+            manager.undoMove();
+        }
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+int64_t Perft::count(BoardManager& manager, const int depth, PerftCache* cache){
+    if (depth == 0) { return 1; }
+
+    const uint64_t key = manager.getZobristHash()->getHash();
+    // depth 1 is cached too - generating a legal move list costs far more than a probe
+    const bool useCache = cache != nullptr;
+    if (useCache) { if (const auto cached = cache->probe(key, depth)) { return *cached; } }
+
+    auto moves = MoveGenerator::getMoves(manager);
+    // the move list is already legal, so its size is the count one ply down
+    int64_t nodes = depth == 1 ? static_cast<int64_t>(moves.size()) : 0;
+    if (depth > 1) {
+        for (Move& move: moves) {
+            manager.forceMove(move);
+            nodes += count(manager, depth - 1, cache);
+            manager.undoMove();
+        }
+    }
+
+    if (useCache) { cache->store(key, depth, nodes); }
+    return nodes;
+}
+
+template<typename Result, typename Count>
+std::vector<Result> Perft::runSubtrees(const BoardManager& manager, const int depth, const int threads,
+                                       int splitDepth, Count countSubtree){
+    // every subtree needs at least one ply left below the split for the leaf tallies to happen
+    splitDepth = std::clamp(splitDepth, 0, std::max(0, depth - 1));
+
+    BoardManager root = manager;
+    std::vector<Move> path;
+    std::vector<std::vector<Move> > subtrees;
+    collectSubtrees(root, splitDepth, path, subtrees);
+
+    WorkStealingPool pool(threads);
+    std::vector<BoardManager> boards(pool.size(), manager);
+    std::vector<Result> results(subtrees.size());
+
+    for (size_t i = 0; i < subtrees.size(); i++) {
+        pool.submit([&, i](const int worker){
+            auto& board = boards[worker];
+            for (auto& move: subtrees[i]) { board.forceMove(move); }
+            results[i] = countSubtree(board, depth - static_cast<int>(subtrees[i].size()));
+            for (size_t undo = 0; undo < subtrees[i].size(); undo++) { board.undoMove(); }
+        });
+    }
+    pool.wait();
+    return results;
+}
+
+PerftResults Perft::parallel(const BoardManager& manager, const int depth, const int threads, const int splitDepth){
+    const auto results = runSubtrees<PerftResults>(manager, depth, threads, splitDepth,
+                                                   [](BoardManager& board, const int remaining){
+                                                       return run(board, remaining);
+                                                   });
+
+    // merged in submission order so the result doesn't depend on scheduling
+    PerftResults total;
+    for (const auto& result: results) { total += result; }
+    return total;
+}
+
+int64_t Perft::parallelCount(const BoardManager& manager, const int depth, const int threads, PerftCache* cache,
+                             const int splitDepth){
+    const auto results = runSubtrees<int64_t>(manager, depth, threads, splitDepth,
+                                              [cache](BoardManager& board, const int remaining){
+                                                  return count(board, remaining, cache);
+                                              });
+
+    int64_t total = 0;
+    for (const auto nodes: results) { total += nodes; }
+    return total;
+}
+
+void Perft::tallyLeaf(const Move& move, PerftResults& result){
+    result.nodes++;
+    if (move.resultBits & CHECK) { result.checks++; }
+    if (move.resultBits & EN_PASSANT) { result.enPassant++; }
+    if (move.resultBits & CAPTURE) { result.captures++; }
+    if (move.resultBits & CASTLING) { result.castling++; }
+    if (move.resultBits & CHECK_MATE) { result.checkMate++; }
+    if (move.resultBits & PROMOTION) { result.promotions++; }
+}
+
+void Perft::collectSubtrees(BoardManager& manager, const int plies, std::vector<Move>& path,
+                            std::vector<std::vector<Move> >& subtrees){
+    if (plies == 0) {
+        subtrees.push_back(path);
+        return;
+    }
+
+    // a line that ends (mate / stalemate) before the split depth has no leaves to count
+    auto moves = MoveGenerator::getMoves(manager);
+    for (auto& move: moves) {
+        manager.forceMove(move);
+        path.push_back(move);
+        collectSubtrees(manager, plies - 1, path, subtrees);
+        path.pop_back();
+        manager.undoMove();
+    }
+}
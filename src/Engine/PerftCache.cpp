@@ -0,0 +1,36 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include "Engine/PerftCache.h"
+
+PerftCache::PerftCache(const size_t sizeInMB){
+    size_t numberEntries = 1;
+    while (numberEntries * 2 <= (sizeInMB * 1024 * 1024) / sizeof(Entry)) { numberEntries *= 2; }
+
+    table_ = std::make_unique<Entry[]>(numberEntries);
+    mask_ = numberEntries - 1;
+}
+
+std::optional<int64_t> PerftCache::probe(const uint64_t key, const int depth) const{
+    const Entry& entry = table_[key & mask_];
+    const uint64_t data = entry.data.load(std::memory_order_relaxed);
+    const uint64_t check = entry.check.load(std::memory_order_relaxed);
+
+    if ((check ^ data) != key || (data & 0xFF) != static_cast<uint8_t>(depth) || data == 0) { return std::nullopt; }
+    return static_cast<int64_t>(data >> 8);
+}
+
+void PerftCache::store(const uint64_t key, const int depth, const int64_t nodes){
+    Entry& entry = table_[key & mask_];
+    const uint64_t data = pack(depth, nodes);
+    entry.check.store(key ^ data, std::memory_order_relaxed);
+    entry.data.store(data, std::memory_order_relaxed);
+}
+
+void PerftCache::clear(){
+    for (size_t i = 0; i <= mask_; i++) {
+        table_[i].check.store(0, std::memory_order_relaxed);
+        table_[i].data.store(0, std::memory_order_relaxed);
+    }
+}
@@ -4,6 +4,43 @@
 
 #include "Engine/ProcessChessEngine.h"
 
+#ifndef _WIN32
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <csignal>
+#include <mutex>
+#include <thread>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <spawn.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+#endif
+
+ProcessChessEngine::ProcessChessEngine(const std::string& exePath) : ChessPlayer(ENGINE){
+    enginePath = exePath;
+    startEngine();
+}
+
+ProcessChessEngine::ProcessChessEngine(const std::string& exePath, const std::string& commsLog) : ChessPlayer(ENGINE){
+    enginePath = exePath;
+    path = std::filesystem::current_path();
+    path += "/commsLog" + commsLog + ".txt";
+    outStream = std::ofstream(path);
+    startEngine();
+}
+
+void ProcessChessEngine::setEngineID(const std::string& engineID){
+    const auto command = "set id " + engineID;
+    sendCommand(command);
+}
+
+#ifdef _WIN32
+
 void ProcessChessEngine::stopProcess(){
     // Try graceful shutdown first
     if (hChildStdInWrite != NULL) {
@@ -45,19 +82,6 @@ void ProcessChessEngine::stopProcess(){
     }
 }
 
-ProcessChessEngine::ProcessChessEngine(const std::string& exePath, const std::string& commsLog) : ChessPlayer(ENGINE){
-    enginePath = exePath;
-    path = std::filesystem::current_path();
-    path += "/commsLog" + commsLog + ".txt";
-    outStream = std::ofstream(path);
-    startEngine();
-}
-
-void ProcessChessEngine::setEngineID(const std::string& engineID){
-    const auto command = "set id " + engineID;
-    sendCommand(command);
-}
-
 bool ProcessChessEngine::startEngine(){
     SECURITY_ATTRIBUTES saAttr;
     saAttr.nLength = sizeof(SECURITY_ATTRIBUTES);
@@ -140,4 +164,215 @@ std::string ProcessChessEngine::readResponse(){
     }
     outStream << "Sent: " << response << std::endl;
     return response;
-}
\ No newline at end of file
+}
+
+#else
+
+namespace {
+    // spawns are serialised so no child can inherit another engine's pipes before they're marked close-on-exec
+    std::mutex spawnMutex;
+
+    using Clock = std::chrono::steady_clock;
+
+    bool makePipe(int fds[2]){
+        if (pipe(fds) != 0) { return false; }
+        fcntl(fds[0], F_SETFD, FD_CLOEXEC);
+        fcntl(fds[1], F_SETFD, FD_CLOEXEC);
+        return true;
+    }
+
+    void closeFd(int& fd){
+        if (fd >= 0) { close(fd); }
+        fd = -1;
+    }
+
+    int remainingMs(const Clock::time_point deadline){
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(deadline - Clock::now()).count();
+        return static_cast<int>(std::max<int64_t>(0, remaining));
+    }
+}
+
+bool ProcessChessEngine::startEngine(){
+    // writing to an engine that has died should fail the write, not kill the whole match
+    std::signal(SIGPIPE, SIG_IGN);
+
+    std::lock_guard lock(spawnMutex);
+    int toChild[2];
+    int fromChild[2];
+    if (!makePipe(toChild)) { return false; }
+    if (!makePipe(fromChild)) {
+        close(toChild[0]);
+        close(toChild[1]);
+        return false;
+    }
+
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, toChild[0], STDIN_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, fromChild[1], STDOUT_FILENO);
+    posix_spawn_file_actions_adddup2(&actions, fromChild[1], STDERR_FILENO);
+
+    char* argv[] = {enginePath.data(), nullptr};
+    const int error = posix_spawn(&pid_, enginePath.c_str(), &actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+
+    // the child has its own copies of these ends
+    close(toChild[0]);
+    close(fromChild[1]);
+    if (error != 0) {
+        pid_ = -1;
+        close(toChild[1]);
+        close(fromChild[0]);
+        return false;
+    }
+
+    stdinFd_ = toChild[1];
+    stdoutFd_ = fromChild[0];
+    fcntl(stdinFd_, F_SETFL, fcntl(stdinFd_, F_GETFL) | O_NONBLOCK);
+    fcntl(stdoutFd_, F_SETFL, fcntl(stdoutFd_, F_GETFL) | O_NONBLOCK);
+    return true;
+}
+
+void ProcessChessEngine::stopProcess(){
+    if (pid_ > 0) {
+        // ask nicely, then close stdin so it sees EOF even if it doesn't know "quit"
+        sendCommand("quit");
+        closeFd(stdinFd_);
+
+        const auto deadline = Clock::now() + std::chrono::seconds(2);
+        while (pid_ > 0 && Clock::now() < deadline) {
+            if (waitpid(pid_, nullptr, WNOHANG) == pid_) { pid_ = -1; } else {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            }
+        }
+        // didn't exit in time, force it
+        if (pid_ > 0) { kill(); }
+    }
+
+    closeFd(stdinFd_);
+    closeFd(stdoutFd_);
+    pending_.clear();
+}
+
+void ProcessChessEngine::kill(){
+    if (pid_ > 0) {
+        ::kill(pid_, SIGKILL);
+        waitpid(pid_, nullptr, 0);
+        pid_ = -1;
+    }
+    closeFd(stdinFd_);
+    closeFd(stdoutFd_);
+}
+
+bool ProcessChessEngine::isRunning(){
+    if (pid_ <= 0) { return false; }
+    if (waitpid(pid_, nullptr, WNOHANG) == pid_) {
+        pid_ = -1;
+        return false;
+    }
+    return true;
+}
+
+bool ProcessChessEngine::sendCommand(const std::string& command){
+    outStream << "Recieved: " << command << std::endl;
+    if (stdinFd_ < 0) { return false; }
+
+    if (command == "ucinewgame") {
+        // anything still unread belongs to the last game
+        pumpOutput();
+        pending_.clear();
+    }
+
+    const std::string cmd = command + '\n';
+    const auto deadline = Clock::now() + std::chrono::milliseconds(writeTimeoutMs_);
+    size_t written = 0;
+    while (written < cmd.size()) {
+        const ssize_t result = write(stdinFd_, cmd.data() + written, cmd.size() - written);
+        if (result >= 0) {
+            written += result;
+            continue;
+        }
+        if (errno == EINTR) { continue; }
+        if (errno != EAGAIN && errno != EWOULDBLOCK) { return false; }
+
+        // the pipe is full, so the engine has stopped reading - give it until the deadline to catch up
+        pollfd fd{.fd = stdinFd_, .events = POLLOUT, .revents = 0};
+        const int ready = poll(&fd, 1, remainingMs(deadline));
+        if (ready < 0 && errno == EINTR) { continue; }
+        if (ready <= 0) {
+            kill();
+            return false;
+        }
+    }
+    return true;
+}
+
+bool ProcessChessEngine::pumpOutput(){
+    if (stdoutFd_ < 0) { return false; }
+
+    char buffer[4096];
+    while (true) {
+        const ssize_t bytesRead = read(stdoutFd_, buffer, sizeof(buffer));
+        if (bytesRead > 0) {
+            pending_.append(buffer, bytesRead);
+            continue;
+        }
+        if (bytesRead < 0 && errno == EINTR) { continue; }
+        if (bytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) { return true; }
+
+        // EOF or a broken pipe - the engine has gone, though there may still be lines in pending_
+        closeFd(stdoutFd_);
+        return false;
+    }
+}
+
+std::optional<std::string> ProcessChessEngine::takeLine(){
+    const auto newline = pending_.find('\n');
+    if (newline == std::string::npos) { return std::nullopt; }
+
+    std::string line = pending_.substr(0, newline);
+    pending_.erase(0, newline + 1);
+    if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+    outStream << "Sent: " << line << std::endl;
+    return line;
+}
+
+std::optional<std::string> ProcessChessEngine::readLine(const int timeoutMs){
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    while (!hasLine() && stdoutFd_ >= 0) {
+        pollfd fd{.fd = stdoutFd_, .events = POLLIN, .revents = 0};
+        const int ready = poll(&fd, 1, remainingMs(deadline));
+        if (ready < 0 && errno == EINTR) { continue; }
+        if (ready <= 0) { break; }
+        pumpOutput();
+    }
+    return takeLine();
+}
+
+std::string ProcessChessEngine::readResponse(){ return waitForResponse(readTimeoutMs_); }
+
+std::string ProcessChessEngine::waitForResponse(const int timeoutMs){
+    // whole lines only, a partial one stays in pending_ until the rest of it arrives
+    std::string response;
+    if (const auto line = readLine(timeoutMs)) {
+        response += *line + '\n';
+        while (const auto more = takeLine()) { response += *more + '\n'; }
+    }
+    return response;
+}
+
+std::optional<std::string> ProcessChessEngine::request(const std::string& command, const std::string& replyPrefix,
+                                                       const int timeoutMs){
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    if (!sendCommand(command)) { return std::nullopt; }
+
+    while (const auto line = readLine(remainingMs(deadline))) {
+        if (line->starts_with(replyPrefix)) { return line; }
+    }
+
+    // an engine that can't answer in time can't be trusted with the next command either
+    kill();
+    return std::nullopt;
+}
+
+#endif
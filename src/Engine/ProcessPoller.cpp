@@ -0,0 +1,53 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include "Engine/ProcessPoller.h"
+
+#ifndef _WIN32
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+
+#include <poll.h>
+
+#include "Engine/ProcessChessEngine.h"
+
+void ProcessPoller::add(ProcessChessEngine* engine){
+    if (std::ranges::find(engines_, engine) == engines_.end()) { engines_.push_back(engine); }
+}
+
+void ProcessPoller::remove(ProcessChessEngine* engine){ std::erase(engines_, engine); }
+
+std::vector<ProcessChessEngine*> ProcessPoller::wait(const int timeoutMs){
+    const auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(timeoutMs);
+    std::vector<pollfd> fds;
+    std::vector<ProcessChessEngine*> polled;
+
+    while (true) {
+        std::vector<ProcessChessEngine*> ready;
+        for (auto* engine: engines_) { if (engine->hasLine()) { ready.push_back(engine); } }
+        if (!ready.empty()) { return ready; }
+
+        fds.clear();
+        polled.clear();
+        for (auto* engine: engines_) {
+            if (engine->outputFd() < 0) { continue; }
+            fds.push_back(pollfd{.fd = engine->outputFd(), .events = POLLIN, .revents = 0});
+            polled.push_back(engine);
+        }
+        if (fds.empty()) { return {}; }
+
+        const auto remaining = std::chrono::duration_cast<std::chrono::milliseconds>(
+            deadline - std::chrono::steady_clock::now()).count();
+        const int count = poll(fds.data(), fds.size(), static_cast<int>(std::max<int64_t>(0, remaining)));
+        if (count < 0 && errno == EINTR) { continue; }
+        if (count <= 0) { return {}; }
+
+        for (std::size_t i = 0; i < fds.size(); i++) { if (fds[i].revents != 0) { polled[i]->pumpOutput(); } }
+    }
+}
+
+#endif
@@ -0,0 +1,79 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include "Engine/TimeManager.h"
+
+#include <algorithm>
+
+
+void TimeManager::init(const SearchLimits& limits, const Colours sideToMove){
+    start_ = std::chrono::steady_clock::now();
+    bestMoveInstability_ = 0.0f;
+    scale_ = 1.0f;
+    previousScore_.reset();
+
+    // fixed time per move - nothing to plan, soft and hard limits are the same
+    if (limits.movetime.has_value() && !limits.infinite) {
+        timed_ = true;
+        optimumMs_ = maximumMs_ = std::max(1, limits.movetime.value() - MOVE_OVERHEAD_MS);
+        return;
+    }
+
+    if (!limits.hasClock() || limits.infinite) {
+        timed_ = false;
+        optimumMs_ = maximumMs_ = 0;
+        return;
+    }
+
+    timed_ = true;
+    const int remaining = (sideToMove == WHITE ? limits.wtime : limits.btime).value_or(0);
+    const int increment = (sideToMove == WHITE ? limits.winc : limits.binc).value_or(0);
+    const int movesToGo = std::clamp(limits.movestogo.value_or(DEFAULT_MOVES_TO_GO), 1, 50);
+
+    const int available = std::max(1, remaining - MOVE_OVERHEAD_MS);
+
+    // never plan to spend more than 80% of what's left on one move, however the increment looks
+    const int hardCap = std::max(1, available * 4 / 5);
+    optimumMs_ = std::min(available / movesToGo + increment * 3 / 4, hardCap);
+    maximumMs_ = std::min(optimumMs_ * 4, hardCap);
+    optimumMs_ = std::max(1, optimumMs_);
+}
+
+std::chrono::steady_clock::time_point TimeManager::hardDeadline() const{
+    if (!timed_) { return std::chrono::steady_clock::time_point::max(); }
+    return start_ + std::chrono::milliseconds(maximumMs_);
+}
+
+int TimeManager::elapsedMs() const{
+    return static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - start_).count());
+}
+
+void TimeManager::updateIteration(const bool bestMoveChanged, const float score, const uint64_t bestMoveNodes,
+                                  const uint64_t totalNodes){
+    // recent changes of mind count for more than old ones
+    bestMoveInstability_ = bestMoveInstability_ * 0.5f + (bestMoveChanged ? 1.0f : 0.0f);
+    const float instabilityFactor = 1.0f + 0.6f * bestMoveInstability_;
+
+    // the score falling away means we're in trouble, so think harder
+    float scoreFactor = 1.0f;
+    if (previousScore_.has_value() && score < previousScore_.value()) {
+        scoreFactor = std::min(1.0f + (previousScore_.value() - score) / 200.0f, 1.8f);
+    }
+    previousScore_ = score;
+
+    // one move soaking up nearly all the effort means the rest are being refuted quickly
+    float dominanceFactor = 1.0f;
+    if (totalNodes > 0 && static_cast<double>(bestMoveNodes) / static_cast<double>(totalNodes) > 0.85) {
+        dominanceFactor = 0.6f;
+    }
+
+    scale_ = instabilityFactor * scoreFactor * dominanceFactor;
+}
+
+bool TimeManager::shouldStop() const{
+    if (!timed_) { return false; }
+    const float softLimit = std::min(static_cast<float>(optimumMs_) * scale_, static_cast<float>(maximumMs_));
+    return static_cast<float>(elapsedMs()) >= softLimit;
+}
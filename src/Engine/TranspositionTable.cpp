@@ -70,6 +70,14 @@ size_t TranspositionTable::populatedEntries() const{
     return std::ranges::count_if(vectorTable, [](const auto& entry) { return entry.key != 0; });
 }
 
+int TranspositionTable::hashfull() const{
+    const size_t sample = std::min<size_t>(1000, vectorTable.size());
+    if (sample == 0) { return 0; }
+    const auto used = std::count_if(vectorTable.begin(), vectorTable.begin() + sample,
+                                    [](const auto& entry) { return entry.key != 0; });
+    return static_cast<int>(used * 1000 / sample);
+}
+
 void TranspositionTable::clear(){
     vectorTable.clear();
     vectorTable.resize(maxSize);
@@ -0,0 +1,48 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include "Engine/UciWriter.h"
+
+#include <cmath>
+
+#include "Engine/EvaluationValues.h"
+
+
+void UciWriter::line(const std::string_view text){
+    std::lock_guard lock(mutex_);
+    if (muted_) { return; }
+    buffer_.append(text);
+    buffer_.push_back('\n');
+}
+
+void UciWriter::send(const std::string_view text){
+    std::lock_guard lock(mutex_);
+    if (muted_) { return; }
+    buffer_.append(text);
+    buffer_.push_back('\n');
+    flushLocked();
+}
+
+void UciWriter::flush(){
+    std::lock_guard lock(mutex_);
+    flushLocked();
+}
+
+void UciWriter::flushLocked(){
+    if (buffer_.empty()) { return; }
+    out_.write(buffer_.data(), static_cast<std::streamsize>(buffer_.size()));
+    out_.flush();
+    buffer_.clear();
+}
+
+std::string formatUciScore(const float score){
+    const float magnitude = std::abs(score);
+    if (magnitude >= MATE_SCORE - MAX_SEARCH_PLY) {
+        // mate scores are MATE_SCORE less the plies it takes, so convert plies to full moves
+        const int plies = static_cast<int>(MATE_SCORE - magnitude);
+        const int moves = (plies + 1) / 2;
+        return "mate " + std::to_string(score > 0 ? moves : -moves);
+    }
+    return "cp " + std::to_string(static_cast<int>(score));
+}
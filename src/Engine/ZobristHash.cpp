@@ -79,6 +79,10 @@ void ZobristHash::initializeHashFromFen(FenString fenString){
     }
 
     if (fenActiveColour == "b") { hashValue ^= blackToMove; }
+
+    // a placement-only fen is treated as a fresh game, same as the board manager does
+    hashValue ^= castlingKeys[fenCastling.empty() ? ALL_CASTLING_RIGHTS : castlingRightsFromFen(fenCastling)];
+    if (!fenEnPassant.empty() && fenEnPassant != "-") { hashValue ^= enPassantKey(Fen::FenToSquare(fenEnPassant)); }
 }
 
 ZobristHash::ZobristHash(const FenString& fenString){
@@ -202,4 +206,13 @@ void ZobristHash::initZobrist(){
     fillRandomArray(blackKing);
 
     blackToMove = rng();
+
+    // build the rights keys out of one key per right so they combine like the bits do
+    std::array<uint64_t, 4> rightKeys;
+    for (auto& key: rightKeys) { key = rng(); }
+    for (int rights = 0; rights < 16; rights++) {
+        castlingKeys[rights] = 0ULL;
+        for (int bit = 0; bit < 4; bit++) { if (rights & 1 << bit) { castlingKeys[rights] ^= rightKeys[bit]; } }
+    }
+    for (auto& key: enPassantFiles) { key = rng(); }
 }
\ No newline at end of file
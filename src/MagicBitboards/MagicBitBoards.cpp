@@ -5,6 +5,8 @@
 
 #include "MagicBitboards/MagicBitBoards.h"
 
+#include "BoardManager/Position.h"
+
 void MagicBitBoards::initRookMagics(){
     for (int square = 0; square < 64; square++) {
         Magic& magic = rookMagics[square];
@@ -63,7 +65,8 @@ Bitboard MagicBitBoards::getBishopAttacks(const int square, Bitboard occupancy)
     return magic.attacks[occupancy];
 }
 
-Bitboard MagicBitBoards::getMoves(const int square, const Piece& piece, const BitBoards& boards){
+Bitboard MagicBitBoards::getMoves(const int square, const Piece& piece, const BitBoards& boards,
+                                  const uint8_t castlingRights){
     switch (piece) {
         case WR:
         case BR:
@@ -79,11 +82,11 @@ Bitboard MagicBitBoards::getMoves(const int square, const Piece& piece, const Bi
         case BN:
             return rules.knightAttacks[square] & ~boards.getOccupancy(BLACK); // cant go to own square
         case WK: {
-            const Bitboard castling = getCastling(square, piece, boards);
+            const Bitboard castling = getCastling(square, piece, boards, castlingRights);
             return (castling | rules.kingMoves[square]) & ~boards.getOccupancy(WHITE);
         }
         case BK: {
-            const Bitboard castling = getCastling(square, piece, boards);
+            const Bitboard castling = getCastling(square, piece, boards, castlingRights);
             return (castling | rules.kingMoves[square]) & ~boards.getOccupancy(BLACK);
         }
         case BP:
@@ -201,41 +204,63 @@ Bitboard MagicBitBoards::findAttacksForColour(const Colours& colourToGetAttacksF
     return attacks;
 }
 
-Bitboard MagicBitBoards::getCastling(const int square, const Piece& piece, const BitBoards& boards){
+Bitboard MagicBitBoards::getCastling(const int square, const Piece& piece, const BitBoards& boards,
+                                     const uint8_t castlingRights){
     if (piece != WK && piece != BK)
         return 0ULL; // obvs only kings
 
-    if (square != 4 && square != 60)
+    const bool white = piece == WK;
+    const int kingSquare = white ? 4 : 60;
+    if (square != kingSquare)
         return 0ULL; // the square from must be the king start pos
 
-    Bitboard result = 0ULL;
-
-    const auto isQueenSide = {false, true};
-    for (const auto& queenSide: isQueenSide) {
-        // preset the correct side of the board for the mask
-        auto castlingMask = queenSide ? Constants::QUEEN_SIDE_CASTLING : Constants::KING_SIDE_CASTLING;
-        castlingMask &= piece == WK ? Constants::RANK_1 : Constants::RANK_8;
+    const uint8_t kingSideRight = white ? WHITE_KINGSIDE : BLACK_KINGSIDE;
+    const uint8_t queenSideRight = white ? WHITE_QUEENSIDE : BLACK_QUEENSIDE;
+    if (!(castlingRights & (kingSideRight | queenSideRight)))
+        return 0ULL;
 
-        Bitboard castleSquare;
-        if (queenSide) { castleSquare = piece == WK ? 0 : 56; } else { castleSquare = piece == WK ? 7 : 63; }
+    const Colours enemy = white ? BLACK : WHITE;
+    if (isSquareAttacked(kingSquare, enemy, boards))
+        return 0ULL; // can't castle out of check
 
-        if (!boards.getPiece(castleSquare).has_value()) { continue ; } // has to be a piece there
-        // has to be a castle/rook
-        if (boards.getPiece(castleSquare).value() != WR && boards.getPiece(castleSquare).value() != BR) { continue; }
+    const Bitboard occupancy = boards.getOccupancy();
+    const Bitboard ourRooks = boards.getBitboard(white ? WR : BR);
+    Bitboard result = 0ULL;
 
-        if (castlingMask & boards.getOccupancy())
-            continue; // can't castle through an occupied square, check all ranks
+    // king side - f and g have to be empty, and the king can't pass through or land on an attacked square
+    const Bitboard kingSidePath = white ? Constants::WHITE_KS_CASTLING : Constants::BLACK_KS_CASTLING;
+    if (castlingRights & kingSideRight
+        && ourRooks & 1ULL << (kingSquare + 3)
+        && !(occupancy & kingSidePath)
+        && !isSquareAttacked(kingSquare + 1, enemy, boards)
+        && !isSquareAttacked(kingSquare + 2, enemy, boards)) { result |= white ? Constants::G1 : Constants::G8; }
+
+    // queen side - b, c and d have to be empty, but the king never crosses b so it can be attacked
+    const Bitboard queenSidePath = white ? Constants::WHITE_QS_CASTLING : Constants::BLACK_QS_CASTLING;
+    if (castlingRights & queenSideRight
+        && ourRooks & 1ULL << (kingSquare - 4)
+        && !(occupancy & queenSidePath)
+        && !isSquareAttacked(kingSquare - 1, enemy, boards)
+        && !isSquareAttacked(kingSquare - 2, enemy, boards)) { result |= white ? Constants::C1 : Constants::C8; }
 
-        // now take file c out of the equation, as it doesn't matter if that's attacked
-        castlingMask &= ~Constants::FILE_B;
-        const auto attacks = findAttacksForColour(piece == WK ? BLACK : WHITE, boards);
-        if (attacks & castlingMask)
-            continue;
+    return result;
+}
 
-        if (piece == WK) { result |= queenSide ? Constants::C1 : Constants::G1; } else {
-            result |= queenSide ? Constants::C8 : Constants::G8;
-        }
-    }
+bool MagicBitBoards::isSquareAttacked(const int square, const Colours& byColour, const BitBoards& boards){
+    return attackersTo(square, byColour, boards) != 0ULL;
+}
 
-    return result;
-}
\ No newline at end of file
+Bitboard MagicBitBoards::attackersTo(const int square, const Colours& byColour, const BitBoards& boards){
+    // look outwards from the square with each piece's own movement - landing on one of theirs means it attacks us
+    const bool white = byColour == WHITE;
+    const Bitboard occupancy = boards.getOccupancy();
+    const Bitboard queens = boards.getBitboard(white ? WQ : BQ);
+
+    Bitboard attackers = rules.knightAttacks[square] & boards.getBitboard(white ? WN : BN);
+    attackers |= rules.kingMoves[square] & boards.getBitboard(white ? WK : BK);
+    // their pawns attack this square from wherever one of our pawns standing here would attack
+    attackers |= rules.getPseudoPawnAttacks(white ? BP : WP, square) & boards.getBitboard(white ? WP : BP);
+    attackers |= getRookAttacks(square, occupancy) & (boards.getBitboard(white ? WR : BR) | queens);
+    attackers |= getBishopAttacks(square, occupancy) & (boards.getBitboard(white ? WB : BB) | queens);
+    return attackers;
+}
@@ -14,19 +14,11 @@ void ManagerCommandHandler::generateFullPositionCommand(MatchManager* matchManag
 
     fullPositionCommand = "position " + matchManager->startingFen();
 
-    auto& moveHistory = matchManager->getMoveHistory();
+    const auto& moveHistory = matchManager->getMoveHistory();
 
     if (!moveHistory.empty()) {
         fullPositionCommand += " moves ";
-
-        std::vector<std::string> moves;
-        auto tempStack = moveHistory;
-        while (!tempStack.empty()) {
-            moves.push_back(tempStack.top().toUCI());
-            tempStack.pop();
-        }
-
-        for (auto it = moves.rbegin(); it != moves.rend(); ++it) { fullPositionCommand += *it + " "; }
+        for (const auto& move: moveHistory) { fullPositionCommand += move.toUCI() + " "; }
     }
 }
 
@@ -35,6 +27,8 @@ void ManagerCommandHandler::operator()(const StopCommand& cmd, MatchManager* mat
 
 void ManagerCommandHandler::operator()(const IsReadyCommand& cmd, MatchManager* matchManager){}
 
+void ManagerCommandHandler::operator()(const PonderHitCommand& cmd, MatchManager* matchManager){}
+
 void ManagerCommandHandler::operator()(const QuitCommand& cmd, MatchManager* matchManager){}
 
 void ManagerCommandHandler::operator()(const GoCommand& cmd, MatchManager* matchManager){
@@ -73,7 +67,7 @@ void ManagerCommandHandler::operator()(const BestMoveCommand& cmd, MatchManager*
     generateFullPositionCommand(matchManager, fullPositionCommand);
 
     if (matchManager->currentPlayer()->playerType != HUMAN) {
-        matchManager->getGui()->receiveInfoOfEngineMove(matchManager->getMoveHistory().top());
+        matchManager->getGui()->receiveInfoOfEngineMove(matchManager->getMoveHistory().back());
     }
 
     // we've done receiving from the current player and need to swap to forward the command
@@ -97,4 +91,12 @@ void ManagerCommandHandler::operator()(const IDCommand& cmd, MatchManager* match
 
 void ManagerCommandHandler::operator()(const SetIDCommand& cmd, MatchManager* matchManager){
     // not relevant
+}
+
+void ManagerCommandHandler::operator()(const SetOptionCommand& cmd, MatchManager* matchManager){
+    // engines only
+}
+
+void ManagerCommandHandler::operator()(const BenchCommand& cmd, MatchManager* matchManager){
+    // engines only
 }
\ No newline at end of file
@@ -133,23 +133,15 @@ void MatchManager::dumpGameLog(){
     localBoardManager.setFullFen(startingFen());
 
     file << "New Game:" << gamesPlayed << " startpos " << startingFen() << std::endl;
-    auto staticMoveHistory = boardManager.getMoveHistory();
-    std::vector<Move> moves;
-    while (!staticMoveHistory.empty()) {
-        moves.push_back(staticMoveHistory.top());
-        staticMoveHistory.pop();
-    }
-    int i = moves.size() - 1;
-    while (i >= 0) {
+    for (auto move: boardManager.getMoveHistory()) {
         std::string moveOutput;
         moveOutput += "G:" + std::to_string(gamesPlayed);
-        moveOutput += " " + localBoardManager.getFullFen() + " " + moves[i].toUCI();
-        localBoardManager.forceMove(moves[i]);
+        moveOutput += " " + localBoardManager.getFullFen() + " " + move.toUCI();
+        localBoardManager.forceMove(move);
         file << moveOutput << std::endl;
-        i--;
     }
 }
 
 
-std::stack<Move>& MatchManager::getMoveHistory(){ return boardManager.getMoveHistory(); }
+const std::vector<Move>& MatchManager::getMoveHistory(){ return boardManager.getMoveHistory(); }
 void MatchManager::addMove(const std::string& moveUCI){ boardManager.tryMove(moveUCI); }
\ No newline at end of file
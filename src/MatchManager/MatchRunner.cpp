@@ -0,0 +1,342 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include "MatchManager/MatchRunner.h"
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <mutex>
+
+#include "BoardManager/BoardManager.h"
+#include "Engine/InProcessPlayer.h"
+#include "Engine/MoveGenerator.h"
+#include "UCIParsing/UciParser.h"
+#include "Utility/WorkStealingPool.h"
+
+namespace {
+    std::optional<Move> findLegalMove(BoardManager& board, const std::string& moveUCI){
+        // promotions come back as either case depending on the engine
+        const auto sameMove = [&](const std::string& candidate){
+            return std::ranges::equal(candidate, moveUCI, [](const char a, const char b){
+                return std::tolower(static_cast<unsigned char>(a)) == std::tolower(static_cast<unsigned char>(b));
+            });
+        };
+        for (auto& move: MoveGenerator::getMoves(board)) { if (sameMove(move.toUCI())) { return move; } }
+        return std::nullopt;
+    }
+
+    // the result and why, once the game is over
+    std::optional<std::pair<GameOutcome, std::string> > adjudicate(BoardManager& board, const int plies,
+                                                                   const MatchConfig& config){
+        const int result = board.getGameResult();
+        if (result & CHECKMATE) {
+            return std::pair{result & WHITE_WINS ? GameOutcome::WHITE_WIN : GameOutcome::BLACK_WIN, "checkmate"};
+        }
+        if (result & STALEMATE) { return std::pair{GameOutcome::DRAW, "stalemate"}; }
+        if (result & REPETITION) { return std::pair{GameOutcome::DRAW, "repetition"}; }
+        if (result & MOVE_COUNT) { return std::pair{GameOutcome::DRAW, "fifty moves"}; }
+        if (plies >= config.maxPlies) { return std::pair{GameOutcome::DRAW, "max plies"}; }
+        return std::nullopt;
+    }
+
+    SearchLimits searchLimits(const MatchTimeControl& timeControl, const std::array<int, 2>& clocks){
+        if (timeControl.depth) { return SearchLimits{.depth = timeControl.depth}; }
+        if (timeControl.moveTimeMs) { return SearchLimits{.movetime = timeControl.moveTimeMs}; }
+        return SearchLimits{
+                    .wtime = clocks[0], .btime = clocks[1], .winc = timeControl.incrementMs,
+                    .binc = timeControl.incrementMs
+                };
+    }
+
+    std::string goCommand(const MatchTimeControl& timeControl, const std::array<int, 2>& clocks){
+        if (timeControl.depth) { return "go depth " + std::to_string(*timeControl.depth); }
+        if (timeControl.moveTimeMs) { return "go movetime " + std::to_string(*timeControl.moveTimeMs); }
+        const auto increment = std::to_string(timeControl.incrementMs);
+        return "go wtime " + std::to_string(clocks[0]) + " btime " + std::to_string(clocks[1]) + " winc " + increment
+               + " binc " + increment;
+    }
+}
+
+MatchScore GameRecord::scoreForA() const{
+    MatchScore score;
+    if (outcome == GameOutcome::DRAW) { score.draws = 1; } else if (
+        (outcome == GameOutcome::WHITE_WIN) == engineAIsWhite) { score.wins = 1; } else { score.losses = 1; }
+    return score;
+}
+
+bool UciChannel::send(const std::string& command){ return player_->sendCommand(command); }
+
+std::optional<std::string> UciChannel::readLine(const Clock::time_point deadline){
+    while (true) {
+        if (const auto newline = pending_.find('\n'); newline != std::string::npos) {
+            std::string line = pending_.substr(0, newline);
+            pending_.erase(0, newline + 1);
+            if (!line.empty() && line.back() == '\r') { line.pop_back(); }
+            return line;
+        }
+        const auto now = Clock::now();
+        // a dead engine's read comes back empty straight away, so without this it would spin until the deadline
+        if (now >= deadline || closed()) { return std::nullopt; }
+
+        // a process engine sleeps in poll until it has something, rather than being asked over and over
+        const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(deadline - now).count();
+        pending_ += player_->waitForResponse(static_cast<int>(remaining));
+    }
+}
+
+std::optional<std::string> UciChannel::waitFor(const std::string& token, const Clock::time_point deadline){
+    while (auto line = readLine(deadline)) {
+        if (line->starts_with(token)) { return line; }
+    }
+    return std::nullopt;
+}
+
+bool UciChannel::handshake(const int timeoutMs){
+    const auto deadline = Clock::now() + std::chrono::milliseconds(timeoutMs);
+    if (!send("uci") || !waitFor("uciok", deadline)) { return false; }
+    return send("isready") && waitFor("readyok", deadline).has_value();
+}
+
+MatchRunner::MatchRunner(PlayerFactory factory, MatchConfig config) : factory_(std::move(factory)),
+                                                                       config_(std::move(config)){
+    config_.games = std::max(2, config_.games + config_.games % 2);
+    config_.concurrency = std::max(1, config_.concurrency);
+}
+
+MatchRunner MatchRunner::inProcess(EngineFactory factory, MatchConfig config){
+    MatchRunner runner(PlayerFactory{}, std::move(config));
+    runner.engineFactory_ = std::move(factory);
+    return runner;
+}
+
+GameRecord MatchRunner::playGame(UciChannel& white, UciChannel& black, const FenString& openingFen,
+                                 const MatchConfig& config){
+    GameRecord record;
+    record.openingFen = openingFen;
+
+    BoardManager board;
+    board.setFullFen(openingFen);
+
+    const auto finish = [&](const GameOutcome outcome, const std::string& reason){
+        record.outcome = outcome;
+        record.reason = reason;
+        return record;
+    };
+    const auto loss = [](const Colours loser){
+        return loser == WHITE ? GameOutcome::BLACK_WIN : GameOutcome::WHITE_WIN;
+    };
+
+    std::array<UciChannel*, 2> channels{&white, &black};
+    for (const auto colour: {WHITE, BLACK}) {
+        auto& channel = *channels[colour == WHITE ? 0 : 1];
+        const auto deadline = UciChannel::Clock::now() + std::chrono::milliseconds(config.replyTimeoutMs);
+        channel.send("ucinewgame");
+        // isready also flushes anything left over from the last game, like a late bestmove
+        if (!channel.send("isready") || !channel.waitFor("readyok", deadline)) {
+            return finish(loss(colour), channel.closed() ? "crashed" : "no reply");
+        }
+    }
+
+    const auto& timeControl = config.timeControl;
+    const bool onClock = !timeControl.depth && !timeControl.moveTimeMs;
+    std::array<int, 2> clocks{timeControl.baseMs, timeControl.baseMs};
+    UCIParser parser;
+
+    while (true) {
+        if (const auto end = adjudicate(board, static_cast<int>(record.moves.size()), config)) {
+            return finish(end->first, end->second);
+        }
+
+        const Colours mover = board.getCurrentTurn();
+        const int side = mover == WHITE ? 0 : 1;
+        auto& channel = *channels[side];
+
+        std::string position = openingFen == Fen::FULL_STARTING_FEN
+                                   ? "position startpos"
+                                   : "position fen " + openingFen;
+        if (!record.moves.empty()) {
+            position += " moves";
+            for (const auto& move: record.moves) { position += " " + move; }
+        }
+        channel.send(position);
+        channel.send(goCommand(timeControl, clocks));
+
+        int allowedMs = config.replyTimeoutMs;
+        if (onClock) { allowedMs = clocks[side] + config.timeMarginMs; } else if (timeControl.moveTimeMs) {
+            allowedMs = *timeControl.moveTimeMs + config.timeMarginMs;
+        }
+        const auto started = UciChannel::Clock::now();
+        const auto reply = channel.waitFor("bestmove", started + std::chrono::milliseconds(allowedMs));
+        if (!reply) { return finish(loss(mover), channel.closed() ? "crashed" : onClock ? "time" : "no reply"); }
+
+        if (onClock) {
+            const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+                UciChannel::Clock::now() - started).count();
+            clocks[side] = std::max(0, clocks[side] - static_cast<int>(elapsed)) + timeControl.incrementMs;
+        }
+
+        const auto command = parser.parse(*reply);
+        const auto* bestMove = command ? std::get_if<BestMoveCommand>(&*command) : nullptr;
+        if (bestMove == nullptr) { return finish(loss(mover), "illegal move"); }
+
+        // "0000" or anything not on the legal list loses on the spot
+        auto move = findLegalMove(board, bestMove->move);
+        if (!move) { return finish(loss(mover), "illegal move"); }
+        board.forceMove(*move);
+        record.moves.push_back(bestMove->move);
+    }
+}
+
+GameRecord MatchRunner::playGame(InProcessPlayer& white, InProcessPlayer& black, const FenString& openingFen,
+                                 const MatchConfig& config){
+    GameRecord record;
+    record.openingFen = openingFen;
+
+    BoardManager board;
+    board.setFullFen(openingFen);
+    white.newGame(openingFen);
+    black.newGame(openingFen);
+
+    const auto& timeControl = config.timeControl;
+    const bool onClock = !timeControl.depth && !timeControl.moveTimeMs;
+    std::array<int, 2> clocks{timeControl.baseMs, timeControl.baseMs};
+    std::array<InProcessPlayer*, 2> players{&white, &black};
+
+    while (true) {
+        if (const auto end = adjudicate(board, static_cast<int>(record.moves.size()), config)) {
+            record.outcome = end->first;
+            record.reason = end->second;
+            return record;
+        }
+
+        const Colours mover = board.getCurrentTurn();
+        const int side = mover == WHITE ? 0 : 1;
+        const auto lose = [&](const std::string& reason){
+            record.outcome = mover == WHITE ? GameOutcome::BLACK_WIN : GameOutcome::WHITE_WIN;
+            record.reason = reason;
+            return record;
+        };
+
+        const auto started = std::chrono::steady_clock::now();
+        const auto result = players[side]->search(searchLimits(timeControl, clocks));
+        if (onClock) {
+            const auto elapsed = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - started).count());
+            if (elapsed > clocks[side] + config.timeMarginMs) { return lose("time"); }
+            clocks[side] = std::max(0, clocks[side] - elapsed) + timeControl.incrementMs;
+        }
+
+        // the engine's own board should always agree with ours, but check the move is legal anyway
+        if (result.bestMove.fileFrom == 0) { return lose("illegal move"); }
+        auto move = findLegalMove(board, result.bestMove.toUCI());
+        if (!move) { return lose("illegal move"); }
+
+        white.play(*move);
+        black.play(*move);
+        board.forceMove(*move);
+        record.moves.push_back(move->toUCI());
+    }
+}
+
+MatchScore MatchRunner::tally(const std::vector<GameRecord>& games){
+    MatchScore score;
+    for (const auto& game: games) { score += game.scoreForA(); }
+    return score;
+}
+
+template<typename Seat>
+MatchResult MatchRunner::runSeats(const std::function<std::unique_ptr<Seat>(int engineIndex)>& makeSeat,
+                                  const GameCallback& onGameFinished){
+    WorkStealingPool pool(config_.concurrency);
+
+    // each worker keeps its own pair of engines for the whole match, started the first time it needs them
+    std::vector<std::array<std::unique_ptr<Seat>, 2> > seats(pool.size());
+    std::vector<GameRecord> games(config_.games);
+    std::vector<bool> played(config_.games, false);
+    MatchProgress progress;
+    std::mutex reportMutex;
+    // set once the SPRT has decided - games already underway finish, the rest are skipped
+    std::atomic<bool> decided = false;
+
+    for (int index = 0; index < config_.games; index++) {
+        pool.submit([&, index](const int worker){
+            if (decided) { return; }
+            auto& seat = seats[worker];
+            GameRecord record;
+            record.index = index;
+            record.engineAIsWhite = index % 2 == 0;
+            record.openingFen = config_.openings.empty()
+                                    ? Fen::FULL_STARTING_FEN
+                                    : config_.openings[(index / 2) % config_.openings.size()];
+
+            bool ready = true;
+            for (int engine = 0; engine < 2 && ready; engine++) {
+                if (!seat[engine]) { seat[engine] = makeSeat(engine); }
+                if (!seat[engine]) {
+                    // an engine that can't start forfeits the game
+                    const bool aFailed = engine == 0;
+                    record.outcome = aFailed == record.engineAIsWhite ? GameOutcome::BLACK_WIN : GameOutcome::WHITE_WIN;
+                    record.reason = "no reply";
+                    ready = false;
+                }
+            }
+
+            if (ready) {
+                auto& white = record.engineAIsWhite ? *seat[0] : *seat[1];
+                auto& black = record.engineAIsWhite ? *seat[1] : *seat[0];
+                const auto opening = record.openingFen;
+                record = playGame(white, black, opening, config_);
+                record.index = index;
+                record.engineAIsWhite = index % 2 == 0;
+
+                // an engine that went quiet may still be thinking, start the next game with a fresh one
+                if (record.reason == "no reply" || record.reason == "time") {
+                    const bool whiteLost = record.outcome == GameOutcome::BLACK_WIN;
+                    const int loser = whiteLost == record.engineAIsWhite ? 0 : 1;
+                    seat[loser].reset();
+                }
+            }
+
+            std::lock_guard lock(reportMutex);
+            progress.score += record.scoreForA();
+            games[index] = record;
+            played[index] = true;
+
+            if (const int first = index - index % 2; played[first] && played[first + 1]) {
+                auto pair = games[first].scoreForA();
+                pair += games[first + 1].scoreForA();
+                progress.pentanomial.addPair(pair);
+                if (config_.sprt) {
+                    progress.sprt = sprt(progress.pentanomial, *config_.sprt);
+                    if (progress.sprt->decision != SprtDecision::CONTINUE) { decided = true; }
+                }
+            }
+            if (onGameFinished) { onGameFinished(record, progress); }
+        });
+    }
+    pool.wait();
+
+    MatchResult result;
+    static_cast<MatchProgress&>(result) = progress;
+    for (int index = 0; index < config_.games; index++) {
+        if (played[index]) { result.games.push_back(std::move(games[index])); }
+    }
+    return result;
+}
+
+MatchResult MatchRunner::run(const GameCallback& onGameFinished){
+    if (engineFactory_) {
+        return runSeats<InProcessPlayer>([this](const int engine){
+            return std::make_unique<InProcessPlayer>(engineFactory_(engine));
+        }, onGameFinished);
+    }
+
+    return runSeats<UciChannel>([this](const int engine){
+        auto channel = std::make_unique<UciChannel>(factory_(engine));
+        if (!channel->handshake(config_.replyTimeoutMs)) { channel.reset(); }
+        return channel;
+    }, onGameFinished);
+}
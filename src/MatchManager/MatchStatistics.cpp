@@ -0,0 +1,125 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include "MatchManager/MatchStatistics.h"
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+    // two-sided 95%
+    constexpr double Z_95 = 1.959964;
+    constexpr double SCORE_EPSILON = 1e-6;
+    // empty buckets get this much weight, only so the constrained fit below can move probability into them
+    constexpr double EMPTY_BUCKET_COUNT = 1e-3;
+
+    /*
+     * The maximum likelihood distribution with mean score s, given the observed one p: q_i = p_i / (1 + theta (a_i - s)),
+     * where a_i is bucket i's score and theta makes the means match. The mismatch falls as theta rises, and theta
+     * has to keep every denominator positive, so bisecting between those limits finds it.
+     */
+    double constrainedTheta(const std::array<double, 5>& probabilities, const double score){
+        double lower = -1.0 / (1.0 - score);
+        double upper = 1.0 / score;
+        for (int iteration = 0; iteration < 100; iteration++) {
+            const double theta = (lower + upper) / 2.0;
+            double mismatch = 0.0;
+            for (int bucket = 0; bucket < 5; bucket++) {
+                const double offset = bucket / 4.0 - score;
+                mismatch += probabilities[bucket] * offset / (1.0 + theta * offset);
+            }
+            if (mismatch > 0.0) { lower = theta; } else { upper = theta; }
+        }
+        return (lower + upper) / 2.0;
+    }
+}
+
+double scoreToElo(const double score){
+    const double clamped = std::clamp(score, SCORE_EPSILON, 1.0 - SCORE_EPSILON);
+    return 400.0 * std::log10(clamped / (1.0 - clamped));
+}
+
+double eloToScore(const double elo){ return 1.0 / (1.0 + std::pow(10.0, -elo / 400.0)); }
+
+EloEstimate estimateElo(const MatchScore& score){
+    EloEstimate estimate;
+    const int games = score.games();
+    if (games == 0) { return estimate; }
+
+    const double mean = score.score();
+    // per-game variance of the W/D/L outcomes around the mean score
+    const double variance = (score.wins * std::pow(1.0 - mean, 2) + score.draws * std::pow(0.5 - mean, 2)
+                             + score.losses * std::pow(0.0 - mean, 2)) / games;
+    const double standardError = std::sqrt(variance / games);
+
+    estimate.elo = scoreToElo(mean);
+    const double upper = scoreToElo(mean + Z_95 * standardError);
+    const double lower = scoreToElo(mean - Z_95 * standardError);
+    estimate.errorMargin = (upper - lower) / 2.0;
+
+    const int decisive = score.wins + score.losses;
+    if (decisive > 0) {
+        estimate.los = 0.5 * (1.0 + std::erf((score.wins - score.losses) / std::sqrt(2.0 * decisive)));
+    }
+    return estimate;
+}
+
+std::string EloEstimate::toString() const{
+    char buffer[96];
+    std::snprintf(buffer, sizeof(buffer), "Elo: %.1f +/- %.1f, LOS: %.1f%%", elo, errorMargin, los * 100.0);
+    return buffer;
+}
+
+std::string PentanomialScore::toString() const{
+    char buffer[96];
+    std::snprintf(buffer, sizeof(buffer), "Ptnml(0-2): %d, %d, %d, %d, %d", pairs[0], pairs[1], pairs[2], pairs[3],
+                  pairs[4]);
+    return buffer;
+}
+
+SprtResult sprt(const PentanomialScore& score, const SprtConfig& config){
+    SprtResult result;
+    result.lowerBound = std::log(config.beta / (1.0 - config.alpha));
+    result.upperBound = std::log((1.0 - config.beta) / config.alpha);
+    if (score.total() == 0) { return result; }
+
+    std::array<double, 5> probabilities{};
+    double weight = 0.0;
+    for (int bucket = 0; bucket < 5; bucket++) {
+        probabilities[bucket] = std::max(static_cast<double>(score.pairs[bucket]), EMPTY_BUCKET_COUNT);
+        weight += probabilities[bucket];
+    }
+    for (auto& probability: probabilities) { probability /= weight; }
+
+    const double score0 = eloToScore(config.elo0);
+    const double score1 = eloToScore(config.elo1);
+    const double theta0 = constrainedTheta(probabilities, score0);
+    const double theta1 = constrainedTheta(probabilities, score1);
+
+    // log(q1_i / q0_i) only depends on the two denominators, since both fits start from the same p_i
+    double perPair = 0.0;
+    for (int bucket = 0; bucket < 5; bucket++) {
+        const double points = bucket / 4.0;
+        perPair += probabilities[bucket] * (std::log(1.0 + theta0 * (points - score0))
+                                            - std::log(1.0 + theta1 * (points - score1)));
+    }
+    result.llr = perPair * score.total();
+
+    if (result.llr >= result.upperBound) { result.decision = SprtDecision::ACCEPT_H1; } else if (
+        result.llr <= result.lowerBound) { result.decision = SprtDecision::ACCEPT_H0; }
+    return result;
+}
+
+std::string SprtResult::toString() const{
+    const char* verdict = decision == SprtDecision::ACCEPT_H1
+                               ? "H1 accepted"
+                               : decision == SprtDecision::ACCEPT_H0
+                                     ? "H0 accepted"
+                                     : "running";
+    char buffer[96];
+    std::snprintf(buffer, sizeof(buffer), "LLR: %.2f (%.2f, %.2f) %s", llr, lowerBound, upperBound, verdict);
+    return buffer;
+}
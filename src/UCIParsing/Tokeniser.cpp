@@ -5,88 +5,90 @@
 #include "UCIParsing/Tokeniser.h"
 
 #include <algorithm>
-#include <iostream>
+#include <array>
+#include <cctype>
+
+namespace {
+    struct Keyword {
+        std::string_view text;
+        TokenType type;
+    };
+
+    // every word the UCI protocol gives a meaning to
+    constexpr std::array keywords = {
+        Keyword{"-", TokenType::DASH},
+        Keyword{"go", TokenType::GO},
+        Keyword{"id", TokenType::ID},
+        Keyword{"on", TokenType::ON},
+        Keyword{"uci", TokenType::UCI},
+        Keyword{"fen", TokenType::FEN},
+        Keyword{"off", TokenType::OFF},
+        Keyword{"set", TokenType::SET},
+        Keyword{"quit", TokenType::QUIT},
+        Keyword{"stop", TokenType::STOP},
+        Keyword{"name", TokenType::SET_OPTION},
+        Keyword{"winc", TokenType::WINC},
+        Keyword{"binc", TokenType::BINC},
+        Keyword{"moves", TokenType::MOVES},
+        Keyword{"depth", TokenType::DEPTH},
+        Keyword{"debug", TokenType::DEBUG},
+        Keyword{"value", TokenType::SET_VALUE},
+        Keyword{"wtime", TokenType::WTIME},
+        Keyword{"btime", TokenType::BTIME},
+        Keyword{"nodes", TokenType::NODES},
+        Keyword{"bench", TokenType::BENCH},
+        Keyword{"ponder", TokenType::PONDER},
+        Keyword{"isready", TokenType::ISREADY},
+        Keyword{"position", TokenType::POSITION_CMD},
+        Keyword{"register", TokenType::REGISTER},
+        Keyword{"bestmove", TokenType::BESTMOVE},
+        Keyword{"startpos", TokenType::START_POS},
+        Keyword{"infinite", TokenType::GO_INFINITE},
+        Keyword{"movetime", TokenType::MOVETIME},
+        Keyword{"setoption", TokenType::SETOPTION},
+        Keyword{"movestogo", TokenType::MOVESTOGO},
+        Keyword{"ponderhit", TokenType::PONDERHIT},
+        Keyword{"ucinewgame", TokenType::UCI_NEW_GAME},
+    };
+
+    constexpr bool isSeparator(const char c){ return c == ' ' || c == '\t' || c == '\r' || c == '\n'; }
+}
 
-Tokeniser::Tokeniser(const std::string& input){ tokenise(input); }
+Tokeniser::Tokeniser(const std::string_view input){ tokenise(input); }
 
 
-void Tokeniser::tokenise(const std::string& input){
-    std::string token;
+void Tokeniser::tokenise(const std::string_view input){
+    tokens.clear();
 
-    for (const auto& c: input) {
-        if (c == ' ') {
-            // outsource handling
-            handleToken(token);
-        }
+    size_t position = 0;
+    while (position < input.size()) {
+        // skip the gap, then take everything up to the next one as a token
+        while (position < input.size() && isSeparator(input[position])) { position++; }
+        const size_t start = position;
+        while (position < input.size() && !isSeparator(input[position])) { position++; }
 
-        // continue building the token
-        else { token += c; }
+        if (position > start) { handleToken(input.substr(start, position - start)); }
     }
 
-    // Handle the last token if input doesn't end with space
-    if (!token.empty()) { handleToken(token); }
-
     tokens.push_back(Token{TokenType::EOF_TOKEN, ""}); // end with EOF
 }
 
-void Tokeniser::handleToken(std::string& builtToken){
-    // search position
-    TokenType type;
-    if (builtToken == "position") { type = TokenType::POSITION_CMD; }
-    // search move
-    else if (builtToken == "moves") { type = TokenType::MOVES; }
-    // search uci
-    else if (builtToken == "uci") { type = TokenType::UCI; }
-    // search go
-    else if (builtToken == "go") { type = TokenType::GO; }
-    // search quit
-    else if (builtToken == "quit") { type = TokenType::QUIT; }
-    // search debug
-    else if (builtToken == "debug") { type = TokenType::DEBUG; }
-    // search isready
-    else if (builtToken == "isready") { type = TokenType::ISREADY; }
-    // search register
-    else if (builtToken == "register") { type = TokenType::REGISTER; }
-    // search setoption
-    else if (builtToken == "setoption") { type = TokenType::SETOPTION; }
-    // search ucinewgame
-    else if (builtToken == "ucinewgame") { type = TokenType::UCI_NEW_GAME; }
-    // search id
-    else if (builtToken == "id") { type = TokenType::ID; }
-    // search bestmove
-    else if (builtToken == "bestmove") { type = TokenType::BESTMOVE; }
-    // search on
-    else if (builtToken == "on") { type = TokenType::ON; }
-    // search off
-    else if (builtToken == "off") { type = TokenType::OFF; }
-    // search stop
-    else if (builtToken == "stop") { type = TokenType::STOP; }
-    // search startpos
-    else if (builtToken == "startpos") { type = TokenType::START_POS; }
-    // search a '-' token
-    else if (builtToken == "-") { type = TokenType::DASH; }
-    // search depth
-    else if (builtToken == "depth") { type = TokenType::DEPTH; }
-    // set token
-    else if (builtToken == "set") { type = TokenType::SET; }
-    // w time
-    else if (builtToken == "wtime") { type = TokenType::WTIME; }
-    // b time
-    else if (builtToken == "btime") { type = TokenType::BTIME; }
-    // w inc
-    else if (builtToken == "winc") { type = TokenType::WINC; }
-    // b inc
-    else if (builtToken == "binc") { type = TokenType::BINC; }
-
-    //unknown token
-    else { type = getUnknownTokenType(builtToken); }
-
-    tokens.emplace_back(type, builtToken);
-
-    builtToken = ""; // empty the token
+void Tokeniser::handleToken(const std::string_view token){
+    TokenType type = getKeywordType(token);
+    if (type == TokenType::UNKNOWN) { type = getUnknownTokenType(token); }
+
+    tokens.emplace_back(type, token);
+}
+
+TokenType Tokeniser::getKeywordType(const std::string_view token){
+    // the length and first character rule out nearly every keyword before any full compare
+    for (const auto& [text, type]: keywords) {
+        if (text.size() == token.size() && text[0] == token[0] && text == token) { return type; }
+    }
+    return TokenType::UNKNOWN;
 }
 
-TokenType Tokeniser::getUnknownTokenType(const std::string& token){
+TokenType Tokeniser::getUnknownTokenType(const std::string_view token){
     if (isMove(token))
         return TokenType::MOVE_VALUE;
     if (isPosition(token))
@@ -95,13 +97,11 @@ TokenType Tokeniser::getUnknownTokenType(const std::string& token){
         return TokenType::INT_LITERAL;
     if (isStringLiteral(token))
         return TokenType::STRING_LITERAL;
-    if (token == "\n" || token == "\r")
-        return TokenType::EOF_TOKEN;
 
     return TokenType::UNKNOWN;
 }
 
-bool Tokeniser::isMove(const std::string& token){
+bool Tokeniser::isMove(const std::string_view token){
     if (token.size() < 4)
         return false;
     bool isMove = false;
@@ -128,7 +128,7 @@ bool Tokeniser::isMove(const std::string& token){
 }
 
 
-bool Tokeniser::isPosition(const std::string& token){
+bool Tokeniser::isPosition(const std::string_view token){
     // really weak check if it's a position
     int slashCount = 0;
     for (const auto& c: token) { if (c == '/') { slashCount++; } }
@@ -136,10 +136,10 @@ bool Tokeniser::isPosition(const std::string& token){
 }
 
 
-bool Tokeniser::isIntLiteral(const std::string& token){
+bool Tokeniser::isIntLiteral(const std::string_view token){
     return std::ranges::all_of(token, [](char c) { return std::isdigit(static_cast<unsigned char>(c)); });
 }
 
-bool Tokeniser::isStringLiteral(const std::string& token){
+bool Tokeniser::isStringLiteral(const std::string_view token){
     return std::ranges::all_of(token, [](char c) { return std::isalpha(static_cast<unsigned char>(c)); });
 }
\ No newline at end of file
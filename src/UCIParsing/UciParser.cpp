@@ -1,14 +1,25 @@
 #include "UCIParsing/UciParser.h"
 
-#include <iostream>
+#include <algorithm>
+#include <charconv>
 #include <string>
 
 #include "UCIParsing/Tokeniser.h"
 
-std::optional<Command> UCIParser::parse(const std::string& inString){
+namespace {
+    template<typename T>
+    std::optional<T> toNumber(const std::string_view token){
+        T value{};
+        const auto [end, error] = std::from_chars(token.data(), token.data() + token.size(), value);
+        if (error != std::errc{} || end != token.data() + token.size()) { return std::nullopt; }
+        return value;
+    }
+}
+
+std::optional<Command> UCIParser::parse(const std::string_view inString){
     currentToken = 0;
-    auto tokeniser = Tokeniser(inString);
-    tokens = tokeniser.getTokens();
+    tokeniser.tokenise(inString);
+    const auto& tokens = tokeniser.getTokens();
 
     while (currentToken < tokens.size()) {
         const Token liveToken = consume();
@@ -23,6 +34,8 @@ std::optional<Command> UCIParser::parse(const std::string& inString){
 
         if (liveToken.type == TokenType::ISREADY) { return IsReadyCommand{}; }
 
+        if (liveToken.type == TokenType::PONDERHIT) { return PonderHitCommand{}; }
+
         if (liveToken.type == TokenType::UCI_NEW_GAME) { return NewGameCommand{}; }
 
         if (liveToken.type == TokenType::GO) { return parseGo(); }
@@ -32,6 +45,10 @@ std::optional<Command> UCIParser::parse(const std::string& inString){
         if (liveToken.type == TokenType::BESTMOVE) { return parseBestMove(); }
 
         if (liveToken.type == TokenType::SET) { return parseSetIDCommand(); }
+
+        if (liveToken.type == TokenType::SETOPTION) { return parseSetOption(); }
+
+        if (liveToken.type == TokenType::BENCH) { return parseBench(); }
     }
 
     return std::nullopt; // no valid command found
@@ -39,7 +56,7 @@ std::optional<Command> UCIParser::parse(const std::string& inString){
 
 
 Token UCIParser::peek(){
-    if (currentToken < tokens.size()) { return tokens.at(currentToken); }
+    if (const auto& tokens = tokeniser.getTokens(); currentToken < tokens.size()) { return tokens[currentToken]; }
     return Token{.type = TokenType::EOF_TOKEN, .value = ""};
 }
 
@@ -58,20 +75,34 @@ std::optional<Command> UCIParser::parsePosition(){
         consume();
     }
     // if we don't get a startpos, means we need to try and parse the fen
-    else if (peek().type == TokenType::FEN_BODY) {
-        std::string fenBody = peek().value;
-        consume();
-        result.isStartPos = false;
-        result.fen = fenBody;
-
-        while (peek().type == TokenType::STRING_LITERAL
-               || peek().type == TokenType::INT_LITERAL
-               || peek().type == TokenType::DASH
-        ) { result.fen += ' ' + consume().value; }
+    else {
+        // "position fen <fen>" is the UCI form, MatchManager sends the fen on its own
+        if (peek().type == TokenType::FEN) { consume(); }
+        if (peek().type == TokenType::FEN_BODY) {
+            // the fen is the board plus up to five fields, all views into the same line,
+            // so copy it out as one span rather than gluing the parts back together
+            const std::string_view fenBody = consume().value;
+            const char* fenEnd = fenBody.data() + fenBody.size();
+            for (int field = 0; field < 5; field++) {
+                if (peek().type == TokenType::MOVES || peek().type == TokenType::EOF_TOKEN) { break; }
+                const std::string_view part = consume().value;
+                fenEnd = part.data() + part.size();
+            }
+            result.isStartPos = false;
+            result.fen.assign(fenBody.data(), fenEnd);
+        }
     }
 
     if (peek().type == TokenType::MOVES) {
         consume();
+
+        const auto& tokens = tokeniser.getTokens();
+        const auto firstMove = tokens.begin() + currentToken;
+        const auto lastMove = std::find_if(firstMove, tokens.end(),
+                                           [](const Token& token) { return token.type != TokenType::MOVE_VALUE; });
+        result.moves.reserve(std::distance(firstMove, lastMove));
+
+        // moves are at most five characters, so these stay in the small string buffer
         while (peek().type == TokenType::MOVE_VALUE) { result.moves.emplace_back(consume().value); }
     }
 
@@ -94,30 +125,55 @@ std::optional<Command> UCIParser::parseGo(){
         || peek().type == TokenType::BTIME
         || peek().type == TokenType::WINC
         || peek().type == TokenType::BINC
+        || peek().type == TokenType::GO_INFINITE
+        || peek().type == TokenType::NODES
+        || peek().type == TokenType::MOVESTOGO
+        || peek().type == TokenType::MOVETIME
+        || peek().type == TokenType::PONDER
     ) {
         auto anchorToken = consume();
         switch (anchorToken.type) {
             case TokenType::DEPTH: {
-                if (peek().type == TokenType::INT_LITERAL) { result.depth = std::stoi(consume().value); }
+                if (peek().type == TokenType::INT_LITERAL) { result.depth = toNumber<int>(consume().value); }
                 break; // break from cases
             }
 
             case TokenType::WTIME: {
-                if (peek().type == TokenType::INT_LITERAL) { result.wtime = std::stoi(consume().value); }
+                if (peek().type == TokenType::INT_LITERAL) { result.wtime = toNumber<int>(consume().value); }
                 break;
             }
 
             case TokenType::BTIME: {
-                if (peek().type == TokenType::INT_LITERAL) { result.btime = std::stoi(consume().value); }
+                if (peek().type == TokenType::INT_LITERAL) { result.btime = toNumber<int>(consume().value); }
                 break;
             }
 
             case TokenType::WINC: {
-                if (peek().type == TokenType::INT_LITERAL) { result.winc = std::stoi(consume().value); }
+                if (peek().type == TokenType::INT_LITERAL) { result.winc = toNumber<int>(consume().value); }
                 break;
             }
             case TokenType::BINC: {
-                if (peek().type == TokenType::INT_LITERAL) { result.binc = std::stoi(consume().value); }
+                if (peek().type == TokenType::INT_LITERAL) { result.binc = toNumber<int>(consume().value); }
+                break;
+            }
+            case TokenType::MOVESTOGO: {
+                if (peek().type == TokenType::INT_LITERAL) { result.movestogo = toNumber<int>(consume().value); }
+                break;
+            }
+            case TokenType::MOVETIME: {
+                if (peek().type == TokenType::INT_LITERAL) { result.movetime = toNumber<int>(consume().value); }
+                break;
+            }
+            case TokenType::NODES: {
+                if (peek().type == TokenType::INT_LITERAL) { result.nodes = toNumber<uint64_t>(consume().value); }
+                break;
+            }
+            case TokenType::PONDER: {
+                result.ponder = true;
+                break;
+            }
+            case TokenType::GO_INFINITE: {
+                result.infinite = true;
                 break;
             }
         }
@@ -126,15 +182,48 @@ std::optional<Command> UCIParser::parseGo(){
 }
 
 std::optional<Command> UCIParser::parseBestMove(){
-    if (peek().type == TokenType::MOVE_VALUE) { return BestMoveCommand{consume().value}; }
+    if (peek().type == TokenType::MOVE_VALUE) { return BestMoveCommand{std::string(consume().value)}; }
     return std::nullopt;
 }
 
 std::optional<Command> UCIParser::parseSetIDCommand(){
     if (peek().type == TokenType::ID && peek().value == "id") {
         consume();
-        if (peek().type == TokenType::STRING_LITERAL) { return SetIDCommand{consume().value}; }
+        if (peek().type == TokenType::STRING_LITERAL) { return SetIDCommand{std::string(consume().value)}; }
     }
 
     return std::nullopt;
 }
+
+std::optional<Command> UCIParser::parseSetOption(){
+    if (peek().type != TokenType::SET_OPTION) { return std::nullopt; }
+    consume();
+
+    // option names can have spaces in them, so take everything up to "value"
+    SetOptionCommand result;
+    while (peek().type != TokenType::SET_VALUE && peek().type != TokenType::EOF_TOKEN) {
+        if (!result.name.empty()) { result.name += ' '; }
+        result.name += consume().value;
+    }
+    if (result.name.empty()) { return std::nullopt; }
+
+    if (peek().type == TokenType::SET_VALUE) {
+        consume();
+        while (peek().type != TokenType::EOF_TOKEN) {
+            if (!result.value.empty()) { result.value += ' '; }
+            result.value += consume().value;
+        }
+    }
+
+    return result;
+}
+
+std::optional<Command> UCIParser::parseBench(){
+    // "bench" or "bench <depth>"
+    BenchCommand result;
+    if (peek().type == TokenType::INT_LITERAL) {
+        result.depth = toNumber<int>(consume().value);
+        if (!result.depth || *result.depth < 1) { return std::nullopt; }
+    }
+    return result;
+}
@@ -0,0 +1,88 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include "Utility/WorkStealingPool.h"
+
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(const int threadCount){
+    const int count = std::max(1, threadCount);
+    queues_.reserve(count);
+    for (int i = 0; i < count; i++) { queues_.push_back(std::make_unique<WorkerQueue>()); }
+    threads_.reserve(count);
+    for (int i = 0; i < count; i++) { threads_.emplace_back(&WorkStealingPool::workerLoop, this, i); }
+}
+
+WorkStealingPool::~WorkStealingPool(){
+    {
+        std::lock_guard lock(sleepMutex_);
+        stopping_ = true;
+    }
+    workAvailable_.notify_all();
+    for (auto& thread: threads_) { thread.join(); }
+}
+
+void WorkStealingPool::submit(Task task){
+    const size_t target = nextQueue_.fetch_add(1, std::memory_order_relaxed) % queues_.size();
+    pending_.fetch_add(1);
+    {
+        // counted under the sleep lock so a worker can't check, miss it, then sleep through the notify -
+        // and before the push, so a worker that takes the task straight away can't take the count below zero
+        std::lock_guard lock(sleepMutex_);
+        queued_.fetch_add(1);
+    }
+    {
+        std::lock_guard lock(queues_[target]->mutex);
+        queues_[target]->tasks.push_back(std::move(task));
+    }
+    workAvailable_.notify_one();
+}
+
+void WorkStealingPool::wait(){
+    std::unique_lock lock(sleepMutex_);
+    allDone_.wait(lock, [this]{ return pending_.load() == 0; });
+}
+
+int WorkStealingPool::defaultThreadCount(){ return std::max(1u, std::thread::hardware_concurrency()); }
+
+void WorkStealingPool::workerLoop(const int index){
+    while (true) {
+        Task task;
+        if (popLocal(index, task) || steal(index, task)) {
+            queued_.fetch_sub(1);
+            task(index);
+            if (pending_.fetch_sub(1) == 1) {
+                std::lock_guard lock(sleepMutex_);
+                allDone_.notify_all();
+            }
+            continue;
+        }
+
+        std::unique_lock lock(sleepMutex_);
+        workAvailable_.wait(lock, [this]{ return stopping_ || queued_.load() > 0; });
+        if (stopping_ && queued_.load() == 0) { return; }
+    }
+}
+
+bool WorkStealingPool::popLocal(const int index, Task& task){
+    auto& queue = *queues_[index];
+    std::lock_guard lock(queue.mutex);
+    if (queue.tasks.empty()) { return false; }
+    task = std::move(queue.tasks.back());
+    queue.tasks.pop_back();
+    return true;
+}
+
+bool WorkStealingPool::steal(const int thief, Task& task){
+    const int count = static_cast<int>(queues_.size());
+    for (int offset = 1; offset < count; offset++) {
+        auto& victim = *queues_[(thief + offset) % count];
+        std::lock_guard lock(victim.mutex);
+        if (victim.tasks.empty()) { continue; }
+        task = std::move(victim.tasks.front());
+        victim.tasks.pop_front();
+        return true;
+    }
+    return false;
+}
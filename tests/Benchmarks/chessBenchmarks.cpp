@@ -0,0 +1,205 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include <algorithm>
+#include <array>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <benchmark/benchmark.h>
+
+#include "BoardManager/BoardManager.h"
+#include "BoardManager/Referee.h"
+#include "Engine/Evaluation.h"
+#include "Engine/MoveGenerator.h"
+#include "Engine/TranspositionTable.h"
+#include "UCIParsing/UciParser.h"
+#include "Utility/Fen.h"
+
+namespace {
+    struct NamedPosition {
+        const char* name;
+        const FenString& fen;
+    };
+
+    // opening, busy middlegame, sparse endgame, promotion-heavy
+    const std::array<NamedPosition, 4> POSITIONS = {
+                NamedPosition{"startpos", Fen::FULL_STARTING_FEN}, NamedPosition{"kiwipete", Fen::FULL_KIWI_PETE_FEN},
+                NamedPosition{"position3", Fen::FULL_POSITION_3_FEN},
+                NamedPosition{"position4", Fen::FULL_POSITION_4_FEN},
+            };
+
+    void positionArgs(benchmark::internal::Benchmark* bench){
+        for (int i = 0; i < static_cast<int>(POSITIONS.size()); i++) { bench->Arg(i); }
+    }
+
+    BoardManager boardFor(const benchmark::State& state){
+        BoardManager manager;
+        manager.setFullFen(POSITIONS[state.range(0)].fen);
+        return manager;
+    }
+
+    std::vector<uint64_t> randomKeys(const size_t count){
+        std::mt19937_64 rng(2026);
+        std::vector<uint64_t> keys(count);
+        for (auto& key: keys) { key = rng() | 1; } // 0 marks an empty slot
+        return keys;
+    }
+}
+
+static void BM_GetMoves(benchmark::State& state){
+    auto manager = boardFor(state);
+    for (auto _: state) { benchmark::DoNotOptimize(MoveGenerator::getMoves(manager)); }
+    state.SetLabel(POSITIONS[state.range(0)].name);
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GetMoves)->Apply(positionArgs);
+
+static void BM_MakeUnmake(benchmark::State& state){
+    auto manager = boardFor(state);
+    auto moves = MoveGenerator::getMoves(manager);
+    for (auto _: state) {
+        for (auto& move: moves) {
+            manager.forceMove(move);
+            manager.undoMove();
+        }
+    }
+    state.SetLabel(POSITIONS[state.range(0)].name);
+    state.SetItemsProcessed(state.iterations() * static_cast<int64_t>(moves.size()));
+}
+BENCHMARK(BM_MakeUnmake)->Apply(positionArgs);
+
+static void BM_IsKingInCheck(benchmark::State& state){
+    auto manager = boardFor(state);
+    const auto turn = manager.getCurrentTurn();
+    for (auto _: state) {
+        benchmark::DoNotOptimize(Referee::isKingInCheck(*manager.getBitboards(), *manager.getMagicBitBoards(), turn));
+    }
+    state.SetLabel(POSITIONS[state.range(0)].name);
+}
+BENCHMARK(BM_IsKingInCheck)->Apply(positionArgs);
+
+static void BM_RookAttacks(benchmark::State& state){
+    auto manager = BoardManager();
+    manager.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+    const Bitboard occupancy = manager.getBitboards()->getOccupancy();
+    const auto* magic = manager.getMagicBitBoards();
+    for (auto _: state) {
+        for (int square = 0; square < 64; square++) {
+            benchmark::DoNotOptimize(magic->getRookAttacks(square, occupancy));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_RookAttacks);
+
+static void BM_BishopAttacks(benchmark::State& state){
+    auto manager = BoardManager();
+    manager.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+    const Bitboard occupancy = manager.getBitboards()->getOccupancy();
+    const auto* magic = manager.getMagicBitBoards();
+    for (auto _: state) {
+        for (int square = 0; square < 64; square++) {
+            benchmark::DoNotOptimize(magic->getBishopAttacks(square, occupancy));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * 64);
+}
+BENCHMARK(BM_BishopAttacks);
+
+static void BM_Evaluate(benchmark::State& state){
+    auto manager = boardFor(state);
+    Evaluator evaluator(&manager);
+    for (auto _: state) { benchmark::DoNotOptimize(evaluator.evaluate()); }
+    state.SetLabel(POSITIONS[state.range(0)].name);
+}
+BENCHMARK(BM_Evaluate)->Apply(positionArgs);
+
+static void BM_ZobristAddMove(benchmark::State& state){
+    auto manager = boardFor(state);
+    const auto moves = MoveGenerator::getMoves(manager);
+    auto* hash = manager.getZobristHash();
+    for (auto _: state) {
+        // add then take back, so the hash doesn't drift between iterations
+        for (const auto& move: moves) {
+            hash->addMove(move);
+            hash->undoMove(move);
+        }
+        benchmark::DoNotOptimize(hash->getHash());
+    }
+    state.SetLabel(POSITIONS[state.range(0)].name);
+    state.SetItemsProcessed(state.iterations() * 2 * static_cast<int64_t>(moves.size()));
+}
+BENCHMARK(BM_ZobristAddMove)->Apply(positionArgs);
+
+static void BM_TTStore(benchmark::State& state){
+    TranspositionTable table(16);
+    auto keys = randomKeys(1 << 16);
+    size_t next = 0;
+    for (auto _: state) {
+        TTEntry entry{.key = keys[next], .eval = 12.0f, .bestMove = Move(), .depth = 4, .age = 1};
+        table.storeVector(entry);
+        next = (next + 1) & (keys.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TTStore);
+
+static void BM_TTProbe(benchmark::State& state){
+    TranspositionTable table(16);
+    auto keys = randomKeys(1 << 16);
+    // half the probes hit
+    for (size_t i = 0; i < keys.size(); i += 2) {
+        TTEntry entry{.key = keys[i], .eval = 12.0f, .bestMove = Move(), .depth = 4, .age = 1};
+        table.storeVector(entry);
+    }
+    size_t next = 0;
+    for (auto _: state) {
+        benchmark::DoNotOptimize(table.retrieveVector(keys[next]));
+        next = (next + 1) & (keys.size() - 1);
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_TTProbe);
+
+static void BM_UCIParsePosition(benchmark::State& state){
+    UCIParser parser;
+    // a forty move game - the longest line a GUI sends us regularly
+    std::string command = "position startpos moves";
+    const std::array<std::string, 8> shuffle = {"g1f3", "g8f6", "f3g1", "f6g8", "b1c3", "b8c6", "c3b1", "c6b8"};
+    for (int i = 0; i < 80; i++) { command += " " + shuffle[i % shuffle.size()]; }
+
+    for (auto _: state) { benchmark::DoNotOptimize(parser.parse(command)); }
+    state.SetBytesProcessed(state.iterations() * static_cast<int64_t>(command.size()));
+}
+BENCHMARK(BM_UCIParsePosition);
+
+static void BM_UCIParseGo(benchmark::State& state){
+    UCIParser parser;
+    const std::string command = "go wtime 300000 btime 300000 winc 2000 binc 2000 movestogo 40";
+    for (auto _: state) { benchmark::DoNotOptimize(parser.parse(command)); }
+}
+BENCHMARK(BM_UCIParseGo);
+
+// JSON goes to chess_bench.json in the working directory unless told otherwise, so each release's numbers can be diffed
+int main(int argc, char** argv){
+    std::vector<char*> args(argv, argv + argc);
+    std::string outFile = "--benchmark_out=chess_bench.json";
+    std::string outFormat = "--benchmark_out_format=json";
+    const bool hasOut = std::any_of(args.begin() + 1, args.end(), [](const char* arg){
+        return std::string(arg).starts_with("--benchmark_out=");
+    });
+    if (!hasOut) {
+        args.push_back(outFile.data());
+        args.push_back(outFormat.data());
+    }
+
+    int count = static_cast<int>(args.size());
+    benchmark::Initialize(&count, args.data());
+    if (benchmark::ReportUnrecognizedArguments(count, args.data())) { return 1; }
+    benchmark::RunSpecifiedBenchmarks();
+    benchmark::Shutdown();
+    return 0;
+}
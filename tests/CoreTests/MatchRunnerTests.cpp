@@ -0,0 +1,303 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cmath>
+#include <deque>
+
+#include "BoardManager/BoardManager.h"
+#include "Engine/InProcessPlayer.h"
+#include "Engine/MoveGenerator.h"
+#include "MatchManager/MatchRunner.h"
+#include "MatchManager/MatchStatistics.h"
+#include "UCIParsing/UciParser.h"
+
+namespace {
+    // answers like an engine, but just plays the first legal move - or a fixed reply if it's given one
+    class ScriptedPlayer final : public ChessPlayer {
+    public:
+
+        explicit ScriptedPlayer(std::optional<std::string> fixedMove = std::nullopt) : ChessPlayer(ENGINE),
+            fixedMove_(std::move(fixedMove)){}
+
+        bool sendCommand(const std::string& command) override{
+            const auto parsed = parser.parse(command);
+            if (!parsed) { return true; }
+            if (std::holds_alternative<UCICommand>(*parsed)) {
+                replies_.emplace_back("id name scripted");
+                replies_.emplace_back("uciok");
+            } else if (std::holds_alternative<IsReadyCommand>(*parsed)) { replies_.emplace_back("readyok"); } else if (
+                const auto* position = std::get_if<PositionCommand>(&*parsed)) {
+                board_.setFullFen(position->fen);
+                for (const auto& moveUCI: position->moves) {
+                    for (auto& move: MoveGenerator::getMoves(board_)) {
+                        if (move.toUCI() == moveUCI) {
+                            board_.forceMove(move);
+                            break;
+                        }
+                    }
+                }
+            } else if (std::holds_alternative<GoCommand>(*parsed)) {
+                replies_.emplace_back("info depth 1 score cp 0");
+                const auto moves = MoveGenerator::getMoves(board_);
+                const auto move = fixedMove_ ? *fixedMove_ : moves.empty() ? "0000" : moves.front().toUCI();
+                replies_.emplace_back("bestmove " + move);
+            }
+            return true;
+        }
+
+        // hands back everything queued at once, so the runner has to split the lines itself
+        std::string readResponse() override{
+            std::string response;
+            while (!replies_.empty()) {
+                response += replies_.front() + "\n";
+                replies_.pop_front();
+            }
+            return response;
+        }
+
+    private:
+
+        std::optional<std::string> fixedMove_;
+        std::deque<std::string> replies_;
+        BoardManager board_;
+    };
+
+    // hands its replies back a few bytes at a time, the way a pipe can
+    class ChunkedPlayer final : public ChessPlayer {
+    public:
+
+        explicit ChunkedPlayer(std::deque<std::string> chunks) : ChessPlayer(ENGINE), chunks_(std::move(chunks)){}
+
+        bool sendCommand(const std::string&) override{ return true; }
+
+        std::string readResponse() override{
+            if (chunks_.empty()) { return ""; }
+            auto chunk = chunks_.front();
+            chunks_.pop_front();
+            return chunk;
+        }
+
+    private:
+
+        std::deque<std::string> chunks_;
+    };
+
+    MatchConfig quickConfig(const int games, const int concurrency){
+        MatchConfig config;
+        config.games = games;
+        config.concurrency = concurrency;
+        config.timeControl.depth = 1;
+        config.maxPlies = 40;
+        config.replyTimeoutMs = 2000;
+        return config;
+    }
+}
+
+TEST(MatchStatistics, EvenScoreIsZeroElo){
+    const auto estimate = estimateElo(MatchScore{.wins = 100, .draws = 0, .losses = 100});
+    EXPECT_NEAR(estimate.elo, 0.0, 1e-9);
+    EXPECT_NEAR(estimate.errorMargin, 48.46, 0.01);
+    EXPECT_NEAR(estimate.los, 0.5, 1e-9);
+}
+
+TEST(MatchStatistics, EloFromScore){
+    EXPECT_NEAR(scoreToElo(0.75), 190.85, 0.01);
+    EXPECT_NEAR(scoreToElo(0.25), -190.85, 0.01);
+
+    const auto estimate = estimateElo(MatchScore{.wins = 60, .draws = 20, .losses = 20});
+    EXPECT_NEAR(estimate.elo, 147.19, 0.01);
+    EXPECT_NEAR(estimate.errorMargin, 66.01, 0.01);
+    EXPECT_GT(estimate.los, 0.999);
+}
+
+TEST(MatchStatistics, NoGamesIsNoInformation){
+    const auto estimate = estimateElo(MatchScore{});
+    EXPECT_EQ(estimate.elo, 0.0);
+    EXPECT_EQ(estimate.errorMargin, 0.0);
+    EXPECT_EQ(estimate.los, 0.5);
+}
+
+TEST(MatchStatistics, PentanomialBucketsPairsByPoints){
+    PentanomialScore score;
+    score.addPair(MatchScore{.wins = 2});
+    score.addPair(MatchScore{.wins = 1, .draws = 1});
+    score.addPair(MatchScore{.wins = 1, .losses = 1});
+    score.addPair(MatchScore{.draws = 2});
+    score.addPair(MatchScore{.draws = 1, .losses = 1});
+    EXPECT_EQ(score.pairs, (std::array<int, 5>{0, 1, 2, 1, 1}));
+    EXPECT_EQ(score.total(), 5);
+}
+
+TEST(MatchStatistics, SprtLogLikelihoodRatio){
+    const SprtConfig config{.elo0 = 0.0, .elo1 = 5.0, .alpha = 0.05, .beta = 0.05};
+
+    const auto nothingYet = sprt(PentanomialScore{}, config);
+    EXPECT_EQ(nothingYet.llr, 0.0);
+    EXPECT_EQ(nothingYet.decision, SprtDecision::CONTINUE);
+    EXPECT_NEAR(nothingYet.lowerBound, -2.944, 0.001);
+    EXPECT_NEAR(nothingYet.upperBound, 2.944, 0.001);
+
+    const auto slightlyAhead = sprt(PentanomialScore{.pairs = {5, 20, 40, 25, 10}}, config);
+    EXPECT_NEAR(slightlyAhead.llr, 0.375, 0.001);
+    EXPECT_EQ(slightlyAhead.decision, SprtDecision::CONTINUE);
+
+    const auto even = sprt(PentanomialScore{.pairs = {10, 20, 40, 20, 10}}, SprtConfig{.elo0 = 0.0, .elo1 = 10.0});
+    EXPECT_NEAR(even.llr, -0.138, 0.001);
+}
+
+TEST(MatchStatistics, SprtDecidesClearCutResults){
+    const SprtConfig config{.elo0 = 0.0, .elo1 = 5.0};
+    EXPECT_EQ(sprt(PentanomialScore{.pairs = {0, 25, 50, 200, 225}}, config).decision, SprtDecision::ACCEPT_H1);
+    EXPECT_EQ(sprt(PentanomialScore{.pairs = {225, 200, 50, 25, 0}}, config).decision, SprtDecision::ACCEPT_H0);
+    // nothing but drawn pairs is strong evidence there's nothing to find
+    EXPECT_EQ(sprt(PentanomialScore{.pairs = {0, 0, 500, 0, 0}}, config).decision, SprtDecision::ACCEPT_H0);
+}
+
+TEST(MatchStatistics, SprtWaitsOnAFewPairs){
+    // bounds this narrow can't be settled in four games, however one-sided they are
+    const SprtConfig config{.elo0 = 0.0, .elo1 = 5.0};
+    for (const auto& pairs: {std::array<int, 5>{0, 0, 0, 2, 0}, std::array<int, 5>{0, 0, 0, 0, 2},
+                             std::array<int, 5>{2, 0, 0, 0, 0}, std::array<int, 5>{0, 0, 2, 0, 0}}) {
+        const auto result = sprt(PentanomialScore{.pairs = pairs}, config);
+        EXPECT_EQ(result.decision, SprtDecision::CONTINUE);
+        EXPECT_LT(std::abs(result.llr), 0.1);
+    }
+}
+
+TEST(MatchRunner, SplitsRepliesIntoLines){
+    UciChannel channel(std::make_unique<ScriptedPlayer>());
+    ASSERT_TRUE(channel.handshake(1000));
+
+    channel.send("position startpos");
+    channel.send("go depth 1");
+    const auto deadline = UciChannel::Clock::now() + std::chrono::seconds(1);
+    EXPECT_EQ(channel.readLine(deadline), "info depth 1 score cp 0");
+    EXPECT_EQ(channel.readLine(deadline), "bestmove a2a3");
+}
+
+TEST(MatchRunner, JoinsLinesSplitAcrossReads){
+    UciChannel channel(std::make_unique<ChunkedPlayer>(std::deque<std::string>{"info dep", "th 1\nbestm", "ove e2e4",
+                                                                                 "\n", "bestmove"}));
+    const auto deadline = UciChannel::Clock::now() + std::chrono::milliseconds(200);
+    EXPECT_EQ(channel.readLine(deadline), "info depth 1");
+    EXPECT_EQ(channel.readLine(deadline), "bestmove e2e4");
+    // never terminated, so it never turns into a line
+    EXPECT_EQ(channel.readLine(deadline), std::nullopt);
+}
+
+TEST(MatchRunner, ScoresMateInTheOpening){
+    UciChannel white(std::make_unique<ScriptedPlayer>());
+    UciChannel black(std::make_unique<ScriptedPlayer>());
+    ASSERT_TRUE(white.handshake(1000));
+    ASSERT_TRUE(black.handshake(1000));
+
+    // fool's mate, white is already mated
+    const FenString mated = "rnb1kbnr/pppp1ppp/8/4p3/6Pq/5P2/PPPPP2P/RNBQKBNR w KQkq - 1 3";
+    const auto record = MatchRunner::playGame(white, black, mated, quickConfig(2, 1));
+    EXPECT_EQ(record.outcome, GameOutcome::BLACK_WIN);
+    EXPECT_EQ(record.reason, "checkmate");
+    EXPECT_TRUE(record.moves.empty());
+}
+
+TEST(MatchRunner, IllegalMoveLosesTheGame){
+    MatchRunner runner([](const int engineIndex) -> std::unique_ptr<ChessPlayer> {
+        if (engineIndex == 0) { return std::make_unique<ScriptedPlayer>("a1a1"); }
+        return std::make_unique<ScriptedPlayer>();
+    }, quickConfig(4, 2));
+
+    const auto result = runner.run();
+    EXPECT_EQ(result.score.losses, 4);
+    for (const auto& game: result.games) { EXPECT_EQ(game.reason, "illegal move"); }
+}
+
+TEST(MatchRunner, PlaysEveryGameConcurrently){
+    auto config = quickConfig(15, 4);
+    config.openings = {Fen::FULL_STARTING_FEN, Fen::FULL_KIWI_PETE_FEN};
+
+    int reported = 0;
+    MatchRunner runner([](int) { return std::make_unique<ScriptedPlayer>(); }, config);
+    const auto result = runner.run([&](const GameRecord&, const MatchProgress& progress){
+        reported++;
+        EXPECT_EQ(progress.score.games(), reported);
+    });
+
+    // rounded up to whole pairs
+    ASSERT_EQ(result.games.size(), 16);
+    EXPECT_EQ(reported, 16);
+    EXPECT_EQ(result.score.games(), 16);
+    EXPECT_EQ(MatchRunner::tally(result.games).wins, result.score.wins);
+
+    for (int i = 0; i < 16; i++) {
+        const auto& game = result.games[i];
+        EXPECT_EQ(game.index, i);
+        EXPECT_EQ(game.engineAIsWhite, i % 2 == 0);
+        EXPECT_EQ(game.openingFen, config.openings[(i / 2) % 2]);
+        EXPECT_FALSE(game.reason.empty());
+    }
+
+    // both engines play the same way, so each pair of games is the same game with the names swapped
+    for (int i = 0; i < 16; i += 2) {
+        EXPECT_EQ(result.games[i].moves, result.games[i + 1].moves);
+        EXPECT_EQ(result.games[i].scoreForA().wins, result.games[i + 1].scoreForA().losses);
+    }
+}
+
+TEST(InProcessPlayer, KeepsItsTableBetweenMoves){
+    InProcessPlayer player;
+    player.newGame(Fen::FULL_STARTING_FEN);
+    const auto first = player.search(SearchLimits{.depth = 4});
+    ASSERT_NE(first.bestMove.fileFrom, 0);
+
+    auto& table = player.engine().getTranspositionTable();
+    const size_t stored = table.populatedEntries();
+    EXPECT_GT(stored, 0);
+
+    player.play(first.bestMove);
+    const auto reply = player.search(SearchLimits{.depth = 4});
+    EXPECT_NE(reply.bestMove.fileFrom, 0);
+    EXPECT_GE(table.populatedEntries(), stored);
+
+    // only a new game starts it over
+    player.newGame(Fen::FULL_STARTING_FEN);
+    EXPECT_EQ(table.populatedEntries(), 0);
+}
+
+TEST(MatchRunner, PlaysInProcessGames){
+    auto config = quickConfig(4, 2);
+    config.timeControl.depth = 2;
+    config.maxPlies = 30;
+
+    auto runner = MatchRunner::inProcess([](int) { return std::make_unique<ChessEngine>(); }, config);
+    const auto result = runner.run();
+    ASSERT_EQ(result.score.games(), 4);
+    for (const auto& game: result.games) {
+        EXPECT_NE(game.reason, "illegal move");
+        EXPECT_FALSE(game.moves.empty());
+    }
+    // the same engine on both sides searches the same way, so colour-swapped pairs are the same game
+    EXPECT_EQ(result.games[0].moves, result.games[1].moves);
+}
+
+TEST(MatchRunner, SprtStopsTheMatchEarly){
+    auto config = quickConfig(200, 1);
+    // wide bounds, so a one-sided match can settle them well inside 200 games
+    config.sprt = SprtConfig{.elo0 = 0.0, .elo1 = 50.0};
+
+    // engine A loses every game, which the test should see straight away
+    MatchRunner runner([](const int engineIndex) -> std::unique_ptr<ChessPlayer> {
+        if (engineIndex == 0) { return std::make_unique<ScriptedPlayer>("a1a1"); }
+        return std::make_unique<ScriptedPlayer>();
+    }, config);
+
+    const auto result = runner.run();
+    ASSERT_TRUE(result.sprt.has_value());
+    EXPECT_EQ(result.sprt->decision, SprtDecision::ACCEPT_H0);
+    EXPECT_LT(result.games.size(), 200);
+    EXPECT_EQ(result.score.games(), result.games.size());
+    EXPECT_EQ(result.pentanomial.pairs[0], result.pentanomial.total());
+    EXPECT_LE(result.pentanomial.total() * 2, result.games.size());
+}
@@ -2,91 +2,119 @@
 // Created by jacks on 14/07/2025.
 //
 
+#include <chrono>
+#include <cstdio>
 #include <gtest/gtest.h>
 #include "perftTestUtility.h"
 #include "Engine/ChessEngine.h"
+#include "Engine/Perft.h"
 #include "Utility/Fen.h"
+#include "Utility/WorkStealingPool.h"
 
-TEST(Divide, kiwiPeteDivide){
-    constexpr int depth = 1;
-    // get the moves the actual engine think are possible
-    const std::string outputFile = "startPos.txt";
-    EXPECT_TRUE(divideTest(Fen::FULL_KIWI_PETE_FEN, outputFile, depth));
+namespace {
+    const PerftReference& referenceFor(const std::vector<PerftReference>& references, const FenString& fen,
+                                       const int depth){
+        const auto found = std::ranges::find_if(references, [&](const auto& reference){
+            return referenceKey(reference.fen, reference.depth) == referenceKey(fen, depth);
+        });
+        if (found == references.end()) { throw std::runtime_error("no reference for " + fen); }
+        return *found;
+    }
 }
 
-TEST(Divide, kiwiPeteDivide2){
-    constexpr int depth = 2;
-    // get the moves the actual engine think are possible
-    const std::string outputFile = "startPos.txt";
-    EXPECT_TRUE(divideTest(Fen::FULL_KIWI_PETE_FEN, outputFile, depth));
+TEST(Divide, ReferenceFileLoads){
+    const auto references = loadPerftReference();
+    EXPECT_EQ(referenceFor(references, Fen::FULL_STARTING_FEN, 4).total(), 197281);
+    EXPECT_EQ(referenceFor(references, Fen::FULL_KIWI_PETE_FEN, 3).total(), 97862);
+    EXPECT_EQ(referenceFor(references, Fen::FULL_POSITION_3_FEN, 4).total(), 43238);
+    EXPECT_EQ(referenceFor(references, Fen::FULL_POSITION_4_FEN, 3).total(), 9467);
+    EXPECT_EQ(referenceFor(references, Fen::FULL_POSITION_5_FEN, 3).total(), 62379);
+    EXPECT_EQ(referenceFor(references, Fen::FULL_POSITION_6_FEN, 3).total(), 89890);
 }
 
-TEST(Divide, kiwiPeteDivide3){
-    constexpr int depth = 3;
-    // get the moves the actual engine think are possible
-    const std::string outputFile = "kp.txt";
-    EXPECT_TRUE(divideTest(Fen::FULL_KIWI_PETE_FEN, outputFile, depth));
+TEST(Divide, RejectsUnknownVersion){
+    const std::string path = "perft_reference_version_test.txt";
+    std::ofstream(path) << "perft-reference " << PERFT_REFERENCE_VERSION + 1 << "\n";
+    EXPECT_THROW(loadPerftReference(path), std::runtime_error);
+    std::remove(path.c_str());
 }
 
-TEST(Divide, kiwipeteDiveAtLeafInErrorCase){
-    constexpr int depth = 1;
-    // get the moves the actual engine think are possible
-    const std::string outputFile = "kp.txt";
-    EXPECT_TRUE(divideTest("r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/PPN2Q2/2PBBPpP/R3K2R b KQkq - 0 1", outputFile, depth));
-}
+TEST(Divide, MatchesReference){
+    const auto references = loadPerftReference();
+    const auto results = checkPerftReferences(references);
 
-TEST(Divide, perft1Divide){
-    const int depth = 1;
-    // get the moves the actual engine think are possible
-    const std::string outputFile = "startPos.txt";
-    EXPECT_TRUE(divideTest(Fen::FULL_STARTING_FEN, outputFile, depth));
+    ASSERT_EQ(results.size(), references.size());
+    for (size_t i = 0; i < results.size(); i++) {
+        EXPECT_FALSE(results[i].has_value()) << results[i]->toString();
+    }
 }
 
-TEST(Divide, perft2Divide){
-    constexpr int depth = 2;
-    // get the moves the actual engine think are possible
-    const std::string outputFile = "startPos.txt";
-    EXPECT_TRUE(divideTest(Fen::FULL_STARTING_FEN, outputFile, depth));
-}
+TEST(Divide, BisectsToFirstDifferingMove){
+    auto references = loadPerftReference();
 
-TEST(Divide, perft4Divide){
-    constexpr int depth = 4;
-    // get the moves the actual engine think are possible
-    const std::string outputFile = "startPos.txt";
-    EXPECT_TRUE(divideTest(Fen::FULL_STARTING_FEN, outputFile, depth));
-}
+    // pretend the reference disagrees two plies down, after e2e4 e7e5, keeping the totals above consistent
+    BoardManager manager;
+    manager.setFullFen(Fen::FULL_STARTING_FEN);
+    auto e4 = createMove(WP, "e2e4");
+    ASSERT_TRUE(manager.tryMove(e4));
+    const auto& afterE4 = referenceFor(references, manager.getFullFen(), 3);
+    manager.undoMove();
 
-TEST(Divide, position3Divide){
-    constexpr int depth = 1;
-    // get the moves the actual engine think are possible
-    const std::string outputFile = "pos3.txt";
-    EXPECT_TRUE(divideTest(Fen::FULL_POSITION_3_FEN, outputFile, depth));
+    for (auto& reference: references) {
+        if (&reference == &afterE4) {
+            for (auto& [move, nodes]: reference.divide) { if (move == "e7e5") { nodes += 3; } }
+        }
+        if (referenceKey(reference.fen, reference.depth) == referenceKey(Fen::FULL_STARTING_FEN, 4)) {
+            for (auto& [move, nodes]: reference.divide) { if (move == "e2e4") { nodes += 3; } }
+        }
+    }
+
+    const auto index = indexReferences(references);
+    std::vector<std::string> path;
+    const auto mismatch = bisectDivide(manager, referenceFor(references, Fen::FULL_STARTING_FEN, 4), index, path);
+
+    ASSERT_TRUE(mismatch.has_value());
+    EXPECT_EQ(mismatch->path, (std::vector<std::string>{"e2e4", "e7e5"}));
+    EXPECT_EQ(mismatch->depth, 3);
+    EXPECT_EQ(mismatch->expected, mismatch->actual + 3);
+    // the board is left where it started
+    EXPECT_EQ(manager.getFullFen(), Fen::FULL_STARTING_FEN);
 }
 
-TEST(Divide, position3Divide2){
-    constexpr int depth = 2;
-    // get the moves the actual engine think are possible
-    const std::string outputFile = "pos3.txt";
-    EXPECT_TRUE(divideTest(Fen::FULL_POSITION_3_FEN, outputFile, depth));
+TEST(Divide, ReportsMovesMissingFromTheReference){
+    auto reference = loadPerftReference().back();
+    ASSERT_EQ(reference.depth, 1);
+    const auto dropped = reference.divide.front().first;
+    reference.divide.erase(reference.divide.begin());
+
+    BoardManager manager;
+    manager.setFullFen(reference.fen);
+    std::vector<std::string> path;
+    const auto mismatch = bisectDivide(manager, reference, {}, path);
+
+    ASSERT_TRUE(mismatch.has_value());
+    EXPECT_EQ(mismatch->move, dropped);
+    EXPECT_EQ(mismatch->expected, -1);
+    EXPECT_EQ(mismatch->actual, 1);
 }
 
 TEST(Perft, perft1){
     ChessEngine blackEngine;
-    auto blackResultDepth1 = blackEngine.runPerftTest(Fen::STARTING_FEN, 1);
+    auto blackResultDepth1 = blackEngine.runPerftTest(Fen::FULL_STARTING_FEN, 1);
     EXPECT_EQ(blackResultDepth1.nodes, 20);
     EXPECT_EQ(blackResultDepth1.captures, 0);
 }
 
 TEST(Perft, perft2){
     ChessEngine whiteEngine;
-    auto whiteResultDepth1 = whiteEngine.runPerftTest(Fen::STARTING_FEN, 2);
+    auto whiteResultDepth1 = whiteEngine.runPerftTest(Fen::FULL_STARTING_FEN, 2);
     EXPECT_EQ(whiteResultDepth1.nodes, 400);
     EXPECT_EQ(whiteResultDepth1.captures, 0);
 }
 
 TEST(Perft, perft3){
     ChessEngine whiteEngine;
-    auto whiteResultDepth1 = whiteEngine.runPerftTest(Fen::STARTING_FEN, 3);
+    auto whiteResultDepth1 = whiteEngine.runPerftTest(Fen::FULL_STARTING_FEN, 3);
     EXPECT_EQ(whiteResultDepth1.nodes, 8902);
     EXPECT_EQ(whiteResultDepth1.captures, 34);
     EXPECT_EQ(whiteResultDepth1.enPassant, 0);
@@ -96,7 +124,7 @@ TEST(Perft, perft3){
 TEST(Perft, perft4){
     ChessEngine blackEngine;
 
-    auto blackResultDepth1 = blackEngine.runPerftTest(Fen::STARTING_FEN, 4);
+    auto blackResultDepth1 = blackEngine.runPerftTest(Fen::FULL_STARTING_FEN, 4);
     EXPECT_EQ(blackResultDepth1.nodes, 197281);
     EXPECT_EQ(blackResultDepth1.captures, 1576);
     EXPECT_EQ(blackResultDepth1.enPassant, 0);
@@ -107,7 +135,7 @@ TEST(Perft, perft4){
 
 TEST(Perft, kiwiPete1){
     ChessEngine blackEngine;
-    auto blackResultDepth1 = blackEngine.runPerftTest(Fen::KIWI_PETE_FEN, 1);
+    auto blackResultDepth1 = blackEngine.runPerftTest(Fen::FULL_KIWI_PETE_FEN, 1);
     EXPECT_EQ(blackResultDepth1.nodes, 48);
     EXPECT_EQ(blackResultDepth1.captures, 8);
     EXPECT_EQ(blackResultDepth1.castling, 2);
@@ -115,7 +143,7 @@ TEST(Perft, kiwiPete1){
 
 TEST(Perft, kiwiPete2){
     ChessEngine whiteEngine;
-    auto perftResults = whiteEngine.runPerftTest(Fen::KIWI_PETE_FEN, 2);
+    auto perftResults = whiteEngine.runPerftTest(Fen::FULL_KIWI_PETE_FEN, 2);
     EXPECT_EQ(perftResults.nodes, 2039);
     EXPECT_EQ(perftResults.captures, 351);
     EXPECT_EQ(perftResults.castling, 91);
@@ -125,7 +153,7 @@ TEST(Perft, kiwiPete2){
 
 TEST(Perft, kiwiPete3){
     ChessEngine whiteEngine;
-    auto perftResults = whiteEngine.runPerftTest(Fen::KIWI_PETE_FEN, 3);
+    auto perftResults = whiteEngine.runPerftTest(Fen::FULL_KIWI_PETE_FEN, 3);
     EXPECT_EQ(perftResults.nodes, 97862);
     EXPECT_EQ(perftResults.captures, 17102);
     EXPECT_EQ(perftResults.castling, 3162);
@@ -137,7 +165,7 @@ TEST(Perft, kiwiPete3){
 
 TEST(Perft, position3Depth1){
     ChessEngine engine;
-    auto perftResults = engine.runPerftTest(Fen::POSITION_3_FEN, 1);
+    auto perftResults = engine.runPerftTest(Fen::FULL_POSITION_3_FEN, 1);
     EXPECT_EQ(perftResults.nodes, 14);
     EXPECT_EQ(perftResults.captures, 1);
     EXPECT_EQ(perftResults.checks, 2);
@@ -145,21 +173,135 @@ TEST(Perft, position3Depth1){
 
 TEST(Perft, position3Depth2){
     ChessEngine engine;
-    auto perftResults = engine.runPerftTest(Fen::POSITION_3_FEN, 2);
+    auto perftResults = engine.runPerftTest(Fen::FULL_POSITION_3_FEN, 2);
     EXPECT_EQ(perftResults.nodes, 191);
     EXPECT_EQ(perftResults.captures, 14);
     EXPECT_EQ(perftResults.checks, 10);
 }
 
 TEST(Divide, KiwiPeteFix){
-    constexpr int depth = 1;
-    // get the moves the actual engine think are possible
-    const std::string outputFile = "startPos.txt";
-    EXPECT_TRUE(
-        divideTest("r3k2r/p2pqpb1/bn2pnp1/2pPN3/1p2P3/P1N2Q1p/1PPBBPPP/R3K2R w KQkq c6 0 1", outputFile, depth));
+    const FenString fen = "r3k2r/p2pqpb1/bn2pnp1/2pPN3/1p2P3/P1N2Q1p/1PPBBPPP/R3K2R w KQkq c6 0 1";
+    const auto references = loadPerftReference();
 
     auto manager = BoardManager();
-    manager.setFullFen("r3k2r/p2pqpb1/bn2pnp1/2pPN3/1p2P3/P1N2Q1p/1PPBBPPP/R3K2R w KQkq c6 0 1");
+    manager.setFullFen(fen);
+    std::vector<std::string> path;
+    const auto mismatch = bisectDivide(manager, referenceFor(references, fen, 1), indexReferences(references), path);
+    EXPECT_FALSE(mismatch.has_value()) << mismatch->toString();
+
     auto move = createMove(WP, "d5c6");
     EXPECT_TRUE(manager.checkMove(move));
-}
\ No newline at end of file
+}
+
+TEST(Perft, ParallelMatchesSerial){
+    ChessEngine engine;
+    const auto serial = engine.runPerftTest(Fen::FULL_KIWI_PETE_FEN, 3);
+
+    // 0 runs the whole tree as one task, 5 is clamped to leave a ply below the split
+    for (const int splitDepth: {0, 1, 2, 5}) {
+        const auto parallel = engine.runParallelPerftTest(Fen::FULL_KIWI_PETE_FEN, 3, 4, splitDepth);
+        EXPECT_EQ(parallel, serial) << "split depth " << splitDepth;
+    }
+}
+
+TEST(Perft, IgnoresThePreviousPosition){
+    ChessEngine engine;
+    // bare kings, no castling rights and nothing else to carry over
+    engine.setFullFen("4k3/8/8/8/8/8/8/4K3 b - - 0 1");
+    EXPECT_EQ(engine.runPerftTest(Fen::FULL_KIWI_PETE_FEN, 2).nodes, 2039);
+
+    engine.setFullFen("4k3/8/8/8/8/8/8/4K3 b - - 0 1");
+    EXPECT_EQ(engine.runParallelPerftTest(Fen::FULL_KIWI_PETE_FEN, 2, 2).nodes, 2039);
+
+    engine.setFullFen("4k3/8/8/8/8/8/8/4K3 b - - 0 1");
+    const auto divide = engine.runDivideTest(Fen::FULL_KIWI_PETE_FEN, 2);
+    EXPECT_EQ(divide.size(), 48);
+}
+
+TEST(Perft, ParallelPosition3){
+    ChessEngine engine;
+    const auto perftResults = engine.runParallelPerftTest(Fen::FULL_POSITION_3_FEN, 2, 3);
+    EXPECT_EQ(perftResults.nodes, 191);
+    EXPECT_EQ(perftResults.captures, 14);
+    EXPECT_EQ(perftResults.checks, 10);
+}
+
+TEST(Performance, ParallelPerftScaling){
+    ChessEngine engine;
+    const int maxThreads = std::max(4, WorkStealingPool::defaultThreadCount());
+
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto perftResults = engine.runParallelPerftTest(Fen::FULL_KIWI_PETE_FEN, 4, threads);
+        const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+        EXPECT_EQ(perftResults.nodes, 4085603);
+        std::cout << threads << " threads: " << static_cast<double>(perftResults.nodes) / elapsed.count() / 1e6
+                << "M nodes per second" << std::endl;
+    }
+}
+
+TEST(Perft, CacheStoresByKeyAndDepth){
+    PerftCache cache(1);
+    cache.store(0x1234, 3, 97862);
+    EXPECT_EQ(cache.probe(0x1234, 3), 97862);
+    EXPECT_FALSE(cache.probe(0x1234, 2).has_value());
+    EXPECT_FALSE(cache.probe(0x1234 + cache.entries(), 3).has_value()); // same slot, other key
+
+    cache.clear();
+    EXPECT_FALSE(cache.probe(0x1234, 3).has_value());
+}
+
+TEST(Perft, HashedMatchesUncached){
+    const std::vector<std::pair<std::string, int> > positions = {
+                {Fen::FULL_STARTING_FEN, 4}, {Fen::FULL_KIWI_PETE_FEN, 3}, {Fen::FULL_POSITION_3_FEN, 4},
+            };
+
+    for (const auto& [fen, depth]: positions) {
+        BoardManager manager;
+        manager.setFullFen(fen);
+        const int64_t uncached = Perft::count(manager, depth);
+
+        // a tiny table so slots get overwritten constantly
+        PerftCache cache(1);
+        EXPECT_EQ(Perft::count(manager, depth, &cache), uncached) << fen;
+        // second run answers mostly from the cache
+        EXPECT_EQ(Perft::count(manager, depth, &cache), uncached) << fen;
+        EXPECT_EQ(Perft::parallelCount(manager, depth, 4, &cache), uncached) << fen;
+        EXPECT_EQ(manager.getFullFen(), fen);
+    }
+}
+
+TEST(Performance, HashedPerft){
+    BoardManager manager;
+    manager.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+    PerftCache cache(64);
+
+    auto start = std::chrono::steady_clock::now();
+    const int64_t uncached = Perft::count(manager, 4);
+    const auto uncachedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    start = std::chrono::steady_clock::now();
+    const int64_t cached = Perft::count(manager, 4, &cache);
+    const auto cachedTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    EXPECT_EQ(uncached, 4085603);
+    EXPECT_EQ(cached, uncached);
+    std::cout << "perft 4 uncached: " << uncachedTime.count() << "s, hashed: " << cachedTime.count() << "s" <<
+            std::endl;
+}
+
+TEST(Perft, BulkCountPositions4To6){
+    const std::vector<std::pair<std::string, int64_t> > positions = {
+                {Fen::FULL_POSITION_4_FEN, 9467}, {Fen::FULL_POSITION_5_FEN, 62379}, {Fen::FULL_POSITION_6_FEN, 89890},
+            };
+
+    for (const auto& [fen, expected]: positions) {
+        BoardManager manager;
+        manager.setFullFen(fen);
+        EXPECT_EQ(Perft::count(manager, 3), expected) << fen;
+        // the detailed count tallies the last ply from the generator's result bits the same way
+        EXPECT_EQ(Perft::run(manager, 3).nodes, expected) << fen;
+        EXPECT_EQ(manager.getFullFen(), fen);
+    }
+}
@@ -0,0 +1,153 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+#ifndef _WIN32
+
+#include "Engine/ProcessChessEngine.h"
+#include "Engine/ProcessPoller.h"
+#include "MatchManager/MatchRunner.h"
+
+namespace {
+    // cat makes a handy stand-in engine: it answers every line with the same line
+    const std::string echoEngine = "/bin/cat";
+}
+
+TEST(ProcessChessEngine, EchoesThroughThePipes){
+    ProcessChessEngine engine(echoEngine);
+    ASSERT_TRUE(engine.isRunning());
+
+    EXPECT_TRUE(engine.sendCommand("isready"));
+    EXPECT_EQ(engine.readLine(1000), "isready");
+    // nothing more to come, so this waits out its timeout
+    EXPECT_EQ(engine.readLine(20), std::nullopt);
+}
+
+TEST(ProcessChessEngine, ReadResponseHandsBackWholeLines){
+    ProcessChessEngine engine(echoEngine);
+    engine.sendCommand("id name first");
+    engine.sendCommand("uciok");
+
+    std::string response;
+    for (int attempt = 0; attempt < 100 && response.find("uciok\n") == std::string::npos; attempt++) {
+        response += engine.readResponse();
+    }
+    EXPECT_EQ(response, "id name first\nuciok\n");
+}
+
+TEST(ProcessChessEngine, KillsAnEngineThatDoesNotAnswer){
+    ProcessChessEngine engine(echoEngine);
+    // cat only ever says "isready" back, so readyok never comes
+    EXPECT_EQ(engine.request("isready", "readyok", 50), std::nullopt);
+    EXPECT_FALSE(engine.isRunning());
+    EXPECT_FALSE(engine.sendCommand("isready"));
+}
+
+TEST(ProcessChessEngine, KillsAnEngineThatStopsReading){
+    // yes never reads its stdin, so the pipe fills up and stays full
+    ProcessChessEngine engine("/usr/bin/yes");
+    ASSERT_TRUE(engine.isRunning());
+    engine.setWriteTimeout(50);
+
+    const auto started = std::chrono::steady_clock::now();
+    bool written = true;
+    for (int i = 0; i < 64 && written; i++) { written = engine.sendCommand(std::string(4096, 'x')); }
+    const auto elapsed = std::chrono::steady_clock::now() - started;
+
+    EXPECT_FALSE(written);
+    EXPECT_FALSE(engine.isRunning());
+    EXPECT_LT(elapsed, std::chrono::seconds(2));
+}
+
+TEST(ProcessChessEngine, WaitsForAResponse){
+    ProcessChessEngine engine(echoEngine);
+    EXPECT_EQ(engine.waitForResponse(20), "");
+
+    engine.sendCommand("readyok");
+    EXPECT_EQ(engine.waitForResponse(1000), "readyok\n");
+}
+
+TEST(ProcessChessEngine, StopsCleanly){
+    ProcessChessEngine engine(echoEngine);
+    engine.stopProcess();
+    EXPECT_FALSE(engine.isRunning());
+    // safe to call twice, the destructor will
+    engine.stopProcess();
+}
+
+TEST(ProcessChessEngine, MissingExecutableDoesNotStart){
+    ProcessChessEngine engine("/nonexistent/engine");
+    EXPECT_FALSE(engine.isRunning());
+    EXPECT_FALSE(engine.sendCommand("uci"));
+    EXPECT_EQ(engine.readLine(10), std::nullopt);
+}
+
+TEST(ProcessPoller, WaitsOnManyEnginesFromOneThread){
+    std::vector<std::unique_ptr<ProcessChessEngine> > engines;
+    ProcessPoller poller;
+    for (int i = 0; i < 4; i++) {
+        engines.push_back(std::make_unique<ProcessChessEngine>(echoEngine));
+        poller.add(engines.back().get());
+    }
+
+    EXPECT_TRUE(poller.wait(20).empty());
+
+    engines[2]->sendCommand("bestmove e2e4");
+    const auto ready = poller.wait(1000);
+    ASSERT_EQ(ready.size(), 1);
+    EXPECT_EQ(ready.front(), engines[2].get());
+    EXPECT_EQ(ready.front()->takeLine(), "bestmove e2e4");
+
+    // an engine that has gone away drops out rather than waking the poll up forever
+    engines[0]->stopProcess();
+    EXPECT_TRUE(poller.wait(20).empty());
+}
+
+TEST(ProcessChessEngine, CrashedEngineLosesStraightAway){
+    // true exits without a word, the way a crashed engine goes quiet
+    UciChannel crashed(std::make_unique<ProcessChessEngine>("/bin/true"));
+    UciChannel other(std::make_unique<ProcessChessEngine>(echoEngine));
+
+    const auto started = UciChannel::Clock::now();
+    EXPECT_EQ(crashed.readLine(started + std::chrono::seconds(30)), std::nullopt);
+    EXPECT_TRUE(crashed.closed());
+
+    MatchConfig config;
+    config.replyTimeoutMs = 30000;
+    const auto record = MatchRunner::playGame(crashed, other, Fen::FULL_STARTING_FEN, config);
+    EXPECT_EQ(record.outcome, GameOutcome::BLACK_WIN);
+    EXPECT_EQ(record.reason, "crashed");
+    EXPECT_LT(UciChannel::Clock::now() - started, std::chrono::seconds(5));
+}
+
+#ifdef STANDALONE_ENGINE_PATH
+TEST(ProcessChessEngine, PlaysAMatchAgainstTheStandaloneEngine){
+    {
+        ProcessChessEngine engine(STANDALONE_ENGINE_PATH);
+        EXPECT_TRUE(engine.request("uci", "uciok", 5000).has_value());
+        EXPECT_EQ(engine.request("isready", "readyok", 5000), "readyok");
+    }
+
+    MatchConfig config;
+    config.games = 2;
+    config.concurrency = 2;
+    config.timeControl.depth = 1;
+    config.maxPlies = 20;
+    config.replyTimeoutMs = 10000;
+
+    MatchRunner runner([](int) { return std::make_unique<ProcessChessEngine>(STANDALONE_ENGINE_PATH); }, config);
+    const auto result = runner.run();
+    ASSERT_EQ(result.score.games(), 2);
+    for (const auto& game: result.games) {
+        EXPECT_NE(game.reason, "illegal move");
+        EXPECT_NE(game.reason, "no reply");
+        EXPECT_FALSE(game.moves.empty());
+    }
+}
+#endif
+
+#endif
@@ -0,0 +1,61 @@
+//
+// Created by jacks on 19/10/2026.
+//
+
+#include <gtest/gtest.h>
+
+#include "Engine/TimeManager.h"
+
+TEST(TimeManagerTests, UntimedSearchHasNoDeadline){
+    auto manager = TimeManager();
+    manager.init(SearchLimits{.depth = 6}, WHITE);
+    EXPECT_FALSE(manager.isTimed());
+    EXPECT_EQ(manager.hardDeadline(), std::chrono::steady_clock::time_point::max());
+    EXPECT_FALSE(manager.shouldStop());
+
+    manager.init(SearchLimits{.wtime = 1000, .btime = 1000, .infinite = true}, WHITE);
+    EXPECT_FALSE(manager.isTimed());
+}
+
+TEST(TimeManagerTests, MoveTimeIsFixed){
+    auto manager = TimeManager();
+    manager.init(SearchLimits{.movetime = 1000}, BLACK);
+    EXPECT_TRUE(manager.isTimed());
+    EXPECT_EQ(manager.optimumMs(), 1000 - TimeManager::MOVE_OVERHEAD_MS);
+    EXPECT_EQ(manager.maximumMs(), manager.optimumMs());
+}
+
+TEST(TimeManagerTests, UsesOwnClockAndIncrement){
+    auto manager = TimeManager();
+    manager.init(SearchLimits{.wtime = 60000, .btime = 1000, .winc = 1000, .binc = 0}, WHITE);
+    const int whiteOptimum = manager.optimumMs();
+
+    manager.init(SearchLimits{.wtime = 60000, .btime = 1000, .winc = 1000, .binc = 0}, BLACK);
+    const int blackOptimum = manager.optimumMs();
+
+    EXPECT_GT(whiteOptimum, blackOptimum);
+    EXPECT_GT(whiteOptimum, 60000 / TimeManager::DEFAULT_MOVES_TO_GO);
+    EXPECT_LE(manager.optimumMs(), manager.maximumMs());
+}
+
+TEST(TimeManagerTests, MovesToGoNeverOverspends){
+    auto manager = TimeManager();
+    manager.init(SearchLimits{.wtime = 10000, .btime = 10000, .winc = 5000, .movestogo = 1}, WHITE);
+    EXPECT_LT(manager.maximumMs(), 10000);
+
+    manager.init(SearchLimits{.wtime = 10000, .btime = 10000, .movestogo = 10}, WHITE);
+    const int tenToGo = manager.optimumMs();
+    manager.init(SearchLimits{.wtime = 10000, .btime = 10000, .movestogo = 40}, WHITE);
+    EXPECT_GT(tenToGo, manager.optimumMs());
+}
+
+TEST(TimeManagerTests, UnstableSearchKeepsThinking){
+    auto manager = TimeManager();
+    manager.init(SearchLimits{.wtime = 3000, .btime = 3000, .movestogo = 1}, WHITE);
+    EXPECT_FALSE(manager.shouldStop());
+
+    // unstable, falling score - the soft limit stretches towards the maximum
+    manager.updateIteration(true, 0.0f, 10, 100);
+    manager.updateIteration(true, -300.0f, 10, 100);
+    EXPECT_FALSE(manager.shouldStop());
+}
@@ -5,6 +5,12 @@
 #include <gtest/gtest.h>
 #include "UCIParsing/Tokeniser.h"
 #include "UCIParsing/UciParser.h"
+#include "Engine/EvaluationValues.h"
+#include "Engine/UciWriter.h"
+#include "Utility/Fen.h"
+
+#include <chrono>
+#include <sstream>
 
 
 TEST(Tokenisation, BasicTokens){
@@ -170,4 +176,161 @@ TEST(Parsing, GoWithTimeAndDepth){
     EXPECT_EQ(std::get<GoCommand>(*result).wtime, 1000);
     EXPECT_EQ(std::get<GoCommand>(*result).btime, 2000);
     EXPECT_EQ(std::get<GoCommand>(*result).depth, 7);
-}
\ No newline at end of file
+}
+TEST(Parsing, GoInfinite){
+    auto parser = UCIParser{};
+    const auto result = parser.parse("go infinite");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(std::holds_alternative<GoCommand>(*result));
+    EXPECT_TRUE(std::get<GoCommand>(*result).infinite);
+    EXPECT_FALSE(std::get<GoCommand>(*result).depth.has_value());
+}
+
+TEST(Parsing, GoWithNodes){
+    auto parser = UCIParser{};
+    const auto result = parser.parse("go nodes 50000");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(std::holds_alternative<GoCommand>(*result));
+    EXPECT_EQ(std::get<GoCommand>(*result).nodes, 50000);
+}
+
+TEST(Parsing, GoWithFullTimeControl){
+    auto parser = UCIParser{};
+    const auto result = parser.parse("go wtime 30000 btime 29000 winc 500 binc 400 movestogo 12");
+    ASSERT_TRUE(result.has_value());
+    const auto& go = std::get<GoCommand>(*result);
+    EXPECT_EQ(go.wtime, 30000);
+    EXPECT_EQ(go.btime, 29000);
+    EXPECT_EQ(go.winc, 500);
+    EXPECT_EQ(go.binc, 400);
+    EXPECT_EQ(go.movestogo, 12);
+
+    const auto result2 = parser.parse("go movetime 250");
+    ASSERT_TRUE(result2.has_value());
+    EXPECT_EQ(std::get<GoCommand>(*result2).movetime, 250);
+}
+
+TEST(Parsing, PonderCommands){
+    auto parser = UCIParser{};
+    const auto result = parser.parse("go ponder wtime 1000 btime 1000");
+    ASSERT_TRUE(result.has_value());
+    EXPECT_TRUE(std::get<GoCommand>(*result).ponder);
+    EXPECT_EQ(std::get<GoCommand>(*result).wtime, 1000);
+
+    const auto result2 = parser.parse("ponderhit");
+    ASSERT_TRUE(result2.has_value());
+    EXPECT_TRUE(std::holds_alternative<PonderHitCommand>(*result2));
+
+    // the ponder move after a bestmove doesn't get in the way of the move itself
+    const auto result3 = parser.parse("bestmove e2e4 ponder e7e5");
+    ASSERT_TRUE(result3.has_value());
+    EXPECT_EQ(std::get<BestMoveCommand>(*result3).move, "e2e4");
+}
+
+TEST(Parsing, SetOption){
+    auto parser = UCIParser{};
+    const auto result = parser.parse("setoption name MultiPV value 3");
+    ASSERT_TRUE(result.has_value());
+    ASSERT_TRUE(std::holds_alternative<SetOptionCommand>(*result));
+    EXPECT_EQ(std::get<SetOptionCommand>(*result).name, "MultiPV");
+    EXPECT_EQ(std::get<SetOptionCommand>(*result).value, "3");
+
+    const auto result2 = parser.parse("setoption name Clear Hash");
+    ASSERT_TRUE(result2.has_value());
+    EXPECT_EQ(std::get<SetOptionCommand>(*result2).name, "Clear Hash");
+    EXPECT_TRUE(std::get<SetOptionCommand>(*result2).value.empty());
+
+    EXPECT_FALSE(parser.parse("setoption").has_value());
+}
+
+TEST(Parsing, Bench){
+    auto parser = UCIParser{};
+    const auto result = parser.parse("bench");
+    ASSERT_TRUE(result.has_value());
+    ASSERT_TRUE(std::holds_alternative<BenchCommand>(*result));
+    EXPECT_FALSE(std::get<BenchCommand>(*result).depth.has_value());
+
+    const auto withDepth = parser.parse("bench 6");
+    ASSERT_TRUE(withDepth.has_value());
+    EXPECT_EQ(std::get<BenchCommand>(*withDepth).depth, 6);
+
+    EXPECT_FALSE(parser.parse("bench 0").has_value());
+}
+
+TEST(UciOutput, LinesAreBufferedUntilFlushed){
+    std::ostringstream out;
+    auto writer = UciWriter(out);
+    writer.line("info depth 1");
+    writer.line("info depth 2");
+    EXPECT_TRUE(out.str().empty());
+
+    writer.send("bestmove e2e4");
+    EXPECT_EQ(out.str(), "info depth 1\ninfo depth 2\nbestmove e2e4\n");
+}
+
+TEST(UciOutput, ScoresFormatAsCentipawnsOrMate){
+    EXPECT_EQ(formatUciScore(35.0f), "cp 35");
+    EXPECT_EQ(formatUciScore(-120.0f), "cp -120");
+    EXPECT_EQ(formatUciScore(MATE_SCORE - 1), "mate 1");
+    EXPECT_EQ(formatUciScore(MATE_SCORE - 3), "mate 2");
+    EXPECT_EQ(formatUciScore(-MATE_SCORE + 2), "mate -1");
+}
+
+TEST(Tokenisation, AnyWhitespaceSeparatesTokens){
+    auto tokeniser = Tokeniser("go\tdepth  4\r\n");
+    auto& tokens = tokeniser.getTokens();
+
+    ASSERT_EQ(tokens.size(), 4);
+    EXPECT_EQ(tokens[0].type, TokenType::GO);
+    EXPECT_EQ(tokens[1].type, TokenType::DEPTH);
+    EXPECT_EQ(tokens[2].value, "4");
+    EXPECT_EQ(tokens[3].type, TokenType::EOF_TOKEN);
+}
+
+TEST(Parsing, FenWithEnPassantSquare){
+    auto parser = UCIParser{};
+    const auto result = parser.parse(
+        "position rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3 moves e5d6");
+    ASSERT_TRUE(result.has_value());
+    const auto& position = std::get<PositionCommand>(*result);
+    EXPECT_EQ(position.fen, "rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3");
+    ASSERT_EQ(position.moves.size(), 1);
+    EXPECT_EQ(position.moves[0], "e5d6");
+}
+
+TEST(Parsing, PositionWithFenKeyword){
+    auto parser = UCIParser{};
+    const auto result = parser.parse("position fen " + Fen::FULL_KIWI_PETE_FEN + " moves e1g1");
+    ASSERT_TRUE(result.has_value());
+    const auto& position = std::get<PositionCommand>(*result);
+    EXPECT_FALSE(position.isStartPos);
+    EXPECT_EQ(position.fen, Fen::FULL_KIWI_PETE_FEN);
+    ASSERT_EQ(position.moves.size(), 1);
+    EXPECT_EQ(position.moves[0], "e1g1");
+
+    // a fen with only the board still parses
+    const auto boardOnly = parser.parse("position fen " + Fen::KIWI_PETE_FEN);
+    ASSERT_TRUE(boardOnly.has_value());
+    EXPECT_EQ(std::get<PositionCommand>(*boardOnly).fen, Fen::KIWI_PETE_FEN);
+}
+
+TEST(Performance, ParseLongPositionCommand){
+    // a 300 ply game, knights shuffling back and forth
+    std::string command = "position startpos moves";
+    for (int ply = 0; ply < 75; ply++) { command += " g1f3 g8f6 f3g1 f6g8"; }
+
+    auto parser = UCIParser{};
+    constexpr int repeats = 2000;
+    size_t movesParsed = 0;
+
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+        const auto result = parser.parse(command);
+        movesParsed += std::get<PositionCommand>(*result).moves.size();
+    }
+    const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - start);
+
+    EXPECT_EQ(movesParsed, 300 * repeats);
+    std::cout << "300 ply position command: " << elapsed.count() / repeats << "us per parse" << std::endl;
+}
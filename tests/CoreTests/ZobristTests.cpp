@@ -39,9 +39,9 @@ TEST(Zobrist, CaptureMoveUpdatesState){
     // this should result in the following fen:
     std::string hardcodedFen = "rnbqkbnr/pp1ppppp/8/2P5/8/8/PPP1PPPP/RNBQKBNR b KQkq - 0 1";
 
-    // the original hash should track that
+    // the manager's hash should track that - it also knows the en passant square has gone
     auto zobFromScratch = ZobristHash(hardcodedFen);
-    EXPECT_EQ(zob.getHash(), zobFromScratch.getHash());
+    EXPECT_EQ(manager.getZobristHash()->getHash(), zobFromScratch.getHash());
 }
 
 TEST(Zobrist, UndoMoveRestoresState){
@@ -126,9 +126,9 @@ TEST(Zobrist, EnPassantCorrectlyUpdatesState){
     // this should result in the following fen:
     std::string hardcodedFen = "rnbqkbnr/pp1pp1pp/2p2P2/8/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1";
 
-    // the original hash should track that
+    // the manager's hash should track that - it also knows the en passant square has gone
     auto zobFromScratch = ZobristHash(hardcodedFen);
-    EXPECT_EQ(zob.getHash(), zobFromScratch.getHash());
+    EXPECT_EQ(manager.getZobristHash()->getHash(), zobFromScratch.getHash());
 
     auto zobFromFen = ZobristHash(manager.getFullFen());
     std::cout << zobFromFen.getHash();
@@ -226,10 +226,10 @@ TEST(Zobrist, CastlingMovesCorrect){
     ASSERT_TRUE(manager.tryMove(move));
     zob.addMove(move);
 
-    // this should be the fen after castling
+    // this should be the fen after castling - white's rights are gone, which only the manager tracks
     auto targetFen = "rnbqkbnr/ppp1pp1p/8/6p1/3p2P1/5N1B/PPPPPP1P/RNBQ1RK1 b kq - 1 4";
     auto zobFromScratch = ZobristHash(targetFen);
-    EXPECT_EQ(zobFromScratch.getHash(), zob.getHash());
+    EXPECT_EQ(zobFromScratch.getHash(), manager.getZobristHash()->getHash());
 }
 
 TEST(Zobrist, UndoCastlingMoves){
@@ -246,15 +246,39 @@ TEST(Zobrist, UndoCastlingMoves){
     ASSERT_TRUE(manager.tryMove(move));
     zob.addMove(move);
 
-    // this should be the fen after castling
+    // this should be the fen after castling - white's rights are gone, which only the manager tracks
     auto targetFen = "rnbqkbnr/ppp1pp1p/8/6p1/3p2P1/5N1B/PPPPPP1P/RNBQ1RK1 b kq - 1 4";
     auto zobFromScratch = ZobristHash(targetFen);
-    EXPECT_EQ(zobFromScratch.getHash(), zob.getHash());
+    EXPECT_EQ(zobFromScratch.getHash(), manager.getZobristHash()->getHash());
 
     manager.undoMove(move);
     zob.undoMove(move);
 
     EXPECT_EQ(zob.getHash(), preMoveHash);
+    EXPECT_EQ(manager.getZobristHash()->getHash(), preMoveHash);
+}
+
+TEST(Zobrist, CastlingRightsAndEnPassantChangeTheHash){
+    const auto allRights = ZobristHash("r3k2r/8/8/8/8/8/8/R3K2R w KQkq - 0 1");
+    const auto someRights = ZobristHash("r3k2r/8/8/8/8/8/8/R3K2R w Kq - 0 1");
+    const auto noRights = ZobristHash("r3k2r/8/8/8/8/8/8/R3K2R w - - 0 1");
+    EXPECT_NE(allRights.getHash(), someRights.getHash());
+    EXPECT_NE(allRights.getHash(), noRights.getHash());
+    EXPECT_NE(someRights.getHash(), noRights.getHash());
+
+    const auto withEnPassant = ZobristHash("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq d6 0 3");
+    const auto withoutEnPassant = ZobristHash("rnbqkbnr/ppp1pppp/8/3pP3/8/8/PPPP1PPP/RNBQKBNR w KQkq - 0 3");
+    EXPECT_NE(withEnPassant.getHash(), withoutEnPassant.getHash());
+}
+
+TEST(Zobrist, ManagerHashMatchesFenAfterRightsChange){
+    auto manager = BoardManager();
+    manager.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+    ASSERT_TRUE(manager.tryMove("a1b1"));
+    ASSERT_TRUE(manager.tryMove("c7c5"));
+
+    EXPECT_EQ(manager.getFullFen(), "r3k2r/p2pqpb1/bn2pnp1/2pPN3/1p2P3/2N2Q1p/PPPBBPPP/1R2K2R w Kkq c6 0 2");
+    EXPECT_EQ(manager.getZobristHash()->getHash(), ZobristHash(manager.getFullFen()).getHash());
 }
 
 TEST(Zobrist, CollisionRateTest){
@@ -2,8 +2,10 @@
 // Created by jacks on 21/06/2025.
 //
 
+#include <chrono>
 #include <gtest/gtest.h>
 #include "BoardManager/BoardManager.h"
+#include "Engine/MoveGenerator.h"
 #include "BoardManager/Rules.h"
 #include "Utility/Fen.h"
 
@@ -1022,7 +1024,8 @@ TEST(BoardManager, ThreeFoldRepetition){
     auto reverseWhiteMove = createMove(WN, "c3b1");
     auto reverseBlackMove = createMove(BN, "c6b8");
 
-    for (int attempt = 0; attempt < 3; attempt++) {
+    // the starting position counts as the first occurrence
+    for (int attempt = 0; attempt < 2; attempt++) {
         EXPECT_NE(manager.getGameResult(), GameResult::REPETITION | GameResult::DRAW);
         ASSERT_TRUE(manager.tryMove(whiteMove));
         ASSERT_TRUE(manager.tryMove(blackMove));
@@ -1033,6 +1036,83 @@ TEST(BoardManager, ThreeFoldRepetition){
     EXPECT_EQ(manager.getGameResult(), GameResult::REPETITION | GameResult::DRAW);
 }
 
+TEST(BoardManager, RepetitionInsideSearchIsADraw){
+    auto manager = BoardManager();
+    manager.setFullFen(Fen::FULL_STARTING_FEN);
+    for (const auto& move: {"g1f3", "g8f6", "f3g1", "f6g8", "g1f3"}) { ASSERT_TRUE(manager.tryMove(move)); }
+
+    // the position after g1f3 has been seen once before - not a draw for the game, and not for a search that
+    // started after it either, but a search that went through it has just gone round in a circle
+    EXPECT_FALSE(manager.isRepetition(0));
+    EXPECT_FALSE(manager.isRepetition(4));
+    EXPECT_TRUE(manager.isRepetition(5));
+    EXPECT_EQ(manager.getGameResult() & GameResult::DRAW, 0);
+
+    // a pawn move means nothing before it can come round again
+    ASSERT_TRUE(manager.tryMove("e7e5"));
+    EXPECT_EQ(manager.getHalfMoveClock(), 0);
+    for (const auto& move: {"f3g1", "g8f6", "g1f3"}) { ASSERT_TRUE(manager.tryMove(move)); }
+    EXPECT_FALSE(manager.isRepetition(9));
+}
+
+TEST(BoardManager, FiftyMoveRuleUsesHalfMoveClock){
+    auto manager = BoardManager();
+    manager.setFullFen("4k3/8/8/8/8/8/4P3/4K3 w - - 99 80");
+    EXPECT_FALSE(manager.isFiftyMoveDraw());
+
+    ASSERT_TRUE(manager.tryMove("e1d1"));
+    EXPECT_TRUE(manager.isFiftyMoveDraw());
+    EXPECT_EQ(manager.getGameResult(), GameResult::DRAW | GameResult::MOVE_COUNT);
+
+    // a pawn move resets the count instead
+    manager.undoMove();
+    ASSERT_TRUE(manager.tryMove("e2e4"));
+    EXPECT_FALSE(manager.isFiftyMoveDraw());
+
+    // and a long game on its own is not a draw
+    manager.setFullFen(Fen::FULL_STARTING_FEN);
+    const std::array<std::string, 4> shuffle = {"g1f3", "g8f6", "f3g1", "f6g8"};
+    for (int ply = 0; ply < 60; ply++) { ASSERT_TRUE(manager.tryMove(shuffle[ply % 4])); }
+    ASSERT_TRUE(manager.tryMove("e2e4"));
+    const std::array<std::string, 4> blackFirstShuffle = {"g8f6", "g1f3", "f6g8", "f3g1"};
+    for (int ply = 0; ply < 60; ply++) { ASSERT_TRUE(manager.tryMove(blackFirstShuffle[ply % 4])); }
+    EXPECT_GT(manager.getMoveHistory().size(), 100);
+    EXPECT_FALSE(manager.isFiftyMoveDraw());
+}
+
+TEST(BoardManager, CheckersBitboardFindsEveryChecker){
+    auto manager = BoardManager();
+    manager.setFullFen("4r1k1/8/8/8/8/5n2/8/4K3 w - - 0 1");
+    EXPECT_EQ(manager.getCheckers(), 1ULL << 60 | 1ULL << 21); // e8 and f3
+    EXPECT_TRUE(manager.isInCheck());
+
+    manager.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+    EXPECT_EQ(manager.getCheckers(), 0ULL);
+    EXPECT_FALSE(manager.isInCheck());
+}
+
+TEST(BoardManager, NoLegalMovesIsMateOrStalemate){
+    auto manager = BoardManager();
+
+    manager.setFullFen("7k/5Q2/6K1/8/8/8/8/8 b - - 0 1");
+    EXPECT_FALSE(manager.hasAnyLegalMoves());
+    EXPECT_TRUE(manager.isStalemate());
+    EXPECT_FALSE(manager.isCheckmate());
+    EXPECT_TRUE(manager.isGameOver());
+    EXPECT_EQ(manager.getGameResult(), GameResult::DRAW | GameResult::STALEMATE);
+
+    manager.setFullFen("7k/6Q1/6K1/8/8/8/8/8 b - - 0 1");
+    EXPECT_FALSE(manager.hasAnyLegalMoves());
+    EXPECT_TRUE(manager.isCheckmate());
+    EXPECT_FALSE(manager.isStalemate());
+    EXPECT_EQ(manager.getGameResult(), GameResult::CHECKMATE | GameResult::WHITE_WINS);
+
+    // one pawn push is enough to keep the game going
+    manager.setFullFen("7k/5Q2/6K1/8/8/8/p7/8 b - - 0 1");
+    EXPECT_TRUE(manager.hasAnyLegalMoves());
+    EXPECT_FALSE(manager.isGameOver());
+}
+
 TEST(BoardManager, CheckMatesAreFoundGameState){
     auto manager = BoardManager();
     manager.setFullFen("rnbqkbnr/pppp1ppp/8/4p3/6P1/5P2/PPPPP2P/RNBQKBNR b KQkq - 0 1");
@@ -1068,7 +1148,7 @@ TEST(BoardManger, PromotionUpdatesBoardState){
 
     EXPECT_TRUE(manager.getBitboards()->getPiece(56).has_value());
     EXPECT_EQ(manager.getBitboards()->getPiece(56).value(), WQ);
-    EXPECT_EQ(manager.getFullFen(), "Q7/7k/8/8/7r/8/3B4/5K2 b KQkq - 0 1");
+    EXPECT_EQ(manager.getFullFen(), "Q7/7k/8/8/7r/8/3B4/5K2 b - - 0 1");
 }
 
 TEST(BoardManger, PromotionCanBeUndone){
@@ -1097,12 +1177,12 @@ TEST(BoardManager, EnPassantSquareUpdated){
     ASSERT_TRUE(manager.tryMove(blackMove1));
 
     // the en passant vulnerable square appears
-    EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/pp1pp1pp/2p5/4Pp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 1");
+    EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/pp1pp1pp/2p5/4Pp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
 
     // then disappears if we make another move
     auto whiteMove3 = createMove(WP, "e5e6");
     ASSERT_TRUE(manager.tryMove(whiteMove3));
-    EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/pp1pp1pp/2p1P3/5p2/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+    EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/pp1pp1pp/2p1P3/5p2/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 3");
 }
 
 TEST(BoardManager, EnPassantSquareUndone){
@@ -1128,9 +1208,9 @@ TEST(BoardManager, EnPassantSquareUndone){
     ASSERT_TRUE(manager.tryMove(blackMove2));
 
     // the en passant vulnerable square appears
-    EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/pp1pp1pp/2p5/4Pp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 1");
+    EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/pp1pp1pp/2p5/4Pp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3");
     manager.undoMove(blackMove2);
-    EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/pp1ppppp/2p5/4P3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 1");
+    EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/pp1ppppp/2p5/4P3/8/8/PPPP1PPP/RNBQKBNR b KQkq - 0 2");
 }
 
 TEST(BoardManager, PromotionAndCaptureWorkRight){
@@ -1141,7 +1221,7 @@ TEST(BoardManager, PromotionAndCaptureWorkRight){
     auto promoteAndCaptureMove = createMove(BP, "b2a1q");
     ASSERT_TRUE(manager.tryMove(promoteAndCaptureMove));
 
-    EXPECT_EQ(manager.getFullFen(), "r1bqkbnr/3p2pp/2n5/2pQpp2/P1PP4/4PPPP/8/qNB1KBNR w KQkq - 0 1");
+    EXPECT_EQ(manager.getFullFen(), "r1bqkbnr/3p2pp/2n5/2pQpp2/P1PP4/4PPPP/8/qNB1KBNR w Kkq - 0 2");
 }
 
 TEST(BoardManager, CantPromoteInCheck){
@@ -1176,13 +1256,13 @@ TEST(BoardManager, EnPassantUndone){
     manager.setFullFen("rnbqkbnr/pppppppp/8/8/8/P7/1PPPPPPP/RNBQKBNR b KQkq - 0 1");
     auto move = createMove(BP, "a7a5");
     ASSERT_TRUE(manager.tryMove(move));
-    EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/1ppppppp/8/p7/8/P7/1PPPPPPP/RNBQKBNR w KQkq a6 0 1");
+    EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/1ppppppp/8/p7/8/P7/1PPPPPPP/RNBQKBNR w KQkq a6 0 2");
     manager.undoMove(move);
     EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/pppppppp/8/8/8/P7/1PPPPPPP/RNBQKBNR b KQkq - 0 1");
 
     auto move2 = createMove(BP, "b7b6");
     ASSERT_TRUE(manager.tryMove(move2));
-    EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/p1pppppp/1p6/8/8/P7/1PPPPPPP/RNBQKBNR w KQkq - 0 1");
+    EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/p1pppppp/1p6/8/8/P7/1PPPPPPP/RNBQKBNR w KQkq - 0 2");
     manager.undoMove(move2);
     EXPECT_EQ(manager.getFullFen(), "rnbqkbnr/pppppppp/8/8/8/P7/1PPPPPPP/RNBQKBNR b KQkq - 0 1");
 }
@@ -1209,7 +1289,7 @@ TEST(BoardManager, UnsetSetEnPassantSquareOnDoublePawnPushIfOtherMoveMade){
     // make other move
     Move otherMove = createMove(BP, "d8d7");
     ASSERT_TRUE(manager.tryMove(otherMove));
-    EXPECT_EQ(manager.getFullFen(), "8/3p4/8/8/P7/8/8/RNBQKBNR w KQkq - 0 1");
+    EXPECT_EQ(manager.getFullFen(), "8/3p4/8/8/P7/8/8/RNBQKBNR w KQkq - 0 2");
 }
 
 TEST(BoardManager, RestoreEnPassantAfterUndoingOtherMove){
@@ -1224,7 +1304,7 @@ TEST(BoardManager, RestoreEnPassantAfterUndoingOtherMove){
     // make other move
     Move otherMove = createMove(BP, "d8d7");
     ASSERT_TRUE(manager.tryMove(otherMove));
-    EXPECT_EQ(manager.getFullFen(), "8/3p4/8/8/P7/8/8/RNBQKBNR w KQkq - 0 1");
+    EXPECT_EQ(manager.getFullFen(), "8/3p4/8/8/P7/8/8/RNBQKBNR w KQkq - 0 2");
 
     manager.undoMove(otherMove);
     EXPECT_EQ(manager.getFullFen(), "3p4/8/8/8/P7/8/8/RNBQKBNR b KQkq a3 0 1");
@@ -1251,7 +1331,7 @@ TEST(BoardManager, EnPassantSquareIntegrityAfterDeepMoves){
 
     manager.tryMove(pawnPush2);
     EXPECT_EQ(manager.getEnPassantSquare(), -1); // undoes ep square
-    EXPECT_EQ(manager.getFullFen(), "8/8/8/8/P7/1p6/8/RNBQKBNR w KQkq - 0 1");
+    EXPECT_EQ(manager.getFullFen(), "8/8/8/8/P7/1p6/8/RNBQKBNR w KQkq - 0 2");
 
     manager.undoMove(pawnPush2);
     EXPECT_EQ(manager.getEnPassantSquare(), rankAndFileToSquare(3, 1)); // "a3"
@@ -1289,3 +1369,100 @@ TEST(BoardManager, CantFindIllegalMoveInCheck){
     EXPECT_FALSE(manager.checkMove(attemptedMove));
 }
 
+TEST(BoardManager, CastlingRightsFollowKingAndRookMoves){
+    auto manager = BoardManager();
+    manager.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+
+    ASSERT_TRUE(manager.tryMove("h1g1"));
+    EXPECT_EQ(manager.getCastlingRights(), WHITE_QUEENSIDE | BLACK_KINGSIDE | BLACK_QUEENSIDE);
+    ASSERT_TRUE(manager.tryMove("e8d8"));
+    EXPECT_EQ(manager.getCastlingRights(), WHITE_QUEENSIDE);
+
+    // a rook that comes back home doesn't bring the right back with it
+    ASSERT_TRUE(manager.tryMove("g1h1"));
+    EXPECT_EQ(manager.getCastlingRights(), WHITE_QUEENSIDE);
+    EXPECT_FALSE(manager.tryMove("e1g1"));
+
+    manager.undoMove();
+    manager.undoMove();
+    manager.undoMove();
+    EXPECT_EQ(manager.getCastlingRights(), ALL_CASTLING_RIGHTS);
+    EXPECT_EQ(manager.getFullFen(), Fen::FULL_KIWI_PETE_FEN);
+}
+
+TEST(BoardManager, CantCastleOutOfOrThroughCheck){
+    auto manager = BoardManager();
+
+    // the rook on e8 checks the king
+    manager.setFullFen("4r1k1/8/8/8/8/8/8/R3K2R w KQ - 0 1");
+    EXPECT_FALSE(manager.tryMove("e1g1"));
+    EXPECT_FALSE(manager.tryMove("e1c1"));
+
+    // f1 is covered, d1 isn't
+    manager.setFullFen("5rk1/8/8/8/8/8/8/R3K2R w KQ - 0 1");
+    EXPECT_FALSE(manager.tryMove("e1g1"));
+    EXPECT_TRUE(manager.tryMove("e1c1"));
+
+    // the king never crosses b1, so it being covered doesn't matter
+    manager.setFullFen("1r4k1/8/8/8/8/8/8/R3K2R w KQ - 0 1");
+    EXPECT_TRUE(manager.tryMove("e1c1"));
+}
+
+TEST(BoardManager, HistoryGrowsPastInitialCapacity){
+    auto manager = BoardManager();
+    manager.setFullFen(Fen::FULL_STARTING_FEN);
+    const auto startHash = manager.getZobristHash()->getHash();
+    const auto startFen = manager.getFullFen();
+
+    // knights shuffling back and forth until the ply stack has to grow
+    const std::array<std::string, 4> shuffle = {"g1f3", "g8f6", "f3g1", "f6g8"};
+    const int plies = static_cast<int>(BoardManager::INITIAL_PLY_CAPACITY) + 100;
+    for (int ply = 0; ply < plies; ply++) { ASSERT_TRUE(manager.tryMove(shuffle[ply % 4])); }
+    EXPECT_EQ(manager.getMoveHistory().size(), plies);
+    EXPECT_EQ(manager.getHalfMoveClock(), plies);
+
+    for (int ply = 0; ply < plies; ply++) { manager.undoMove(); }
+    EXPECT_EQ(manager.getMoveHistory().size(), 0);
+    EXPECT_EQ(manager.getZobristHash()->getHash(), startHash);
+    EXPECT_EQ(manager.getFullFen(), startFen);
+}
+
+TEST(BoardManager, NullMoveOnlyChangesSideAndEnPassant){
+    auto manager = BoardManager();
+    manager.setFullFen(Fen::FULL_STARTING_FEN);
+    ASSERT_TRUE(manager.tryMove("e2e4"));
+    const auto hashBefore = manager.getZobristHash()->getHash();
+    const auto bitboardsBefore = manager.getBitboards()->getRawBoards();
+
+    manager.makeNullMove();
+    EXPECT_EQ(manager.getCurrentTurn(), WHITE);
+    EXPECT_EQ(manager.getEnPassantSquare(), -1);
+    EXPECT_NE(manager.getZobristHash()->getHash(), hashBefore);
+    EXPECT_EQ(manager.getBitboards()->getRawBoards(), bitboardsBefore);
+
+    manager.undoNullMove();
+    EXPECT_EQ(manager.getCurrentTurn(), BLACK);
+    EXPECT_EQ(manager.getEnPassantSquare(), rankAndFileToSquare(3, 5)); // "e3"
+    EXPECT_EQ(manager.getZobristHash()->getHash(), hashBefore);
+}
+
+TEST(Performance, MakeUnmake){
+    auto manager = BoardManager();
+    manager.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+    auto moves = MoveGenerator::getMoves(manager);
+    const auto startHash = manager.getZobristHash()->getHash();
+
+    constexpr int repeats = 20000;
+    const auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < repeats; i++) {
+        for (auto& move: moves) {
+            manager.forceMove(move);
+            manager.undoMove();
+        }
+    }
+    const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start);
+
+    EXPECT_EQ(manager.getZobristHash()->getHash(), startHash);
+    const auto pairs = static_cast<double>(repeats * moves.size());
+    std::cout << "make/unmake: " << pairs / elapsed.count() / 1e6 << "M per second" << std::endl;
+}
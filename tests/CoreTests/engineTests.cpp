@@ -238,6 +238,16 @@ TEST(Performance, Iterative){
     engine.getTranspositionTable().getStats().print();
 }
 
+TEST(EngineTests, StalemateIsScoredAsADraw){
+    auto engine = ChessEngine();
+
+    // Qf7 leaves black without a move - a queen up, that throws the win away
+    engine.setFullFen("7k/8/6K1/8/8/8/8/5Q2 w - - 0 1");
+    const auto result = engine.Search(3);
+    EXPECT_NE(result.bestMove.toUCI(), "f1f7");
+    EXPECT_GT(result.score, 0.0f);
+}
+
 TEST(EngineTests, TimedSearchGivesSameResult){
     auto engine = ChessEngine();
 
@@ -316,3 +326,240 @@ TEST(EngineTests, FindsFunMateIn5){
 }
 
 
+
+TEST(EngineTests, StaticPruningIsCounted){
+    auto engine = ChessEngine();
+    engine.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+
+    const auto result = engine.Search(4);
+    const auto& stats = result.stats;
+    EXPECT_GT(stats.reverseFutilityPrunes + stats.futilityPrunes + stats.razorPrunes, 0);
+}
+
+TEST(EngineTests, StaticPruningCanBeDisabled){
+    auto engine = ChessEngine();
+    engine.getPruningMargins().enabled = false;
+    engine.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+
+    const auto result = engine.Search(3);
+    EXPECT_EQ(result.stats.reverseFutilityPrunes, 0);
+    EXPECT_EQ(result.stats.futilityPrunes, 0);
+    EXPECT_EQ(result.stats.razorPrunes, 0);
+}
+
+TEST(EngineTests, StaticPruningKeepsMates){
+    auto engine = ChessEngine();
+    engine.setFullFen("6k1/4pp1p/p5p1/1p1q4/4b1N1/P1Q4P/1PP3P1/7K w - - 0 1");
+    EXPECT_EQ(engine.Search(3).bestMove.toUCI(), "g4h6");
+
+    engine.reset();
+    engine.getPruningMargins().futility = {0, 0, 0, 0};
+    engine.getPruningMargins().razoring = {0, 0, 0, 0};
+    engine.getPruningMargins().reverseFutility = {0, 0, 0, 0};
+    engine.setFullFen("4k3/2ppppp1/2ppppp1/8/8/8/3PPP2/1Q2KQ2 w - - 0 1");
+    EXPECT_EQ(engine.Search(3).bestMove.toUCI(), "b1b8");
+}
+
+TEST(EngineTests, PrincipalVariationIsPlayable){
+    auto engine = ChessEngine();
+    engine.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+
+    const auto result = engine.Search(4);
+    ASSERT_FALSE(result.variation.empty());
+    EXPECT_EQ(result.variation.front(), result.bestMove);
+
+    auto manager = BoardManager();
+    manager.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+    for (const auto& move: result.variation) { EXPECT_TRUE(manager.tryMove(move.toUCI())) << move.toUCI(); }
+}
+
+TEST(EngineTests, RootMovesPersistAcrossIterations){
+    auto engine = ChessEngine();
+    engine.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+
+    const auto result = engine.Search(4, 100000);
+    const auto& rootMoves = engine.getRootMoves();
+
+    // one entry per legal move, not one per move per iteration
+    EXPECT_EQ(rootMoves.size(), 48);
+    EXPECT_EQ(engine.getLastSearchEvaluations().moves.size(), 48);
+
+    // the last completed iteration's best move is searched first next time
+    const auto best = std::ranges::max_element(rootMoves, {}, &RootMove::score);
+    EXPECT_EQ(best->move, result.bestMove);
+    EXPECT_GT(best->nodes, 0);
+}
+
+TEST(EngineTests, StopEndsInfiniteSearch){
+    auto engine = ChessEngine();
+    engine.parseUCI("position " + Fen::FULL_KIWI_PETE_FEN);
+
+    testing::internal::CaptureStdout();
+    engine.parseUCI("go infinite");
+    EXPECT_TRUE(engine.isSearching());
+
+    // the input side stays live while the search runs
+    engine.parseUCI("isready");
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    engine.parseUCI("stop");
+    const auto output = testing::internal::GetCapturedStdout();
+
+    EXPECT_FALSE(engine.isSearching());
+    EXPECT_NE(output.find("readyok"), std::string::npos);
+    EXPECT_NE(output.find("bestmove "), std::string::npos);
+    EXPECT_EQ(output.find("bestmove 0000"), std::string::npos);
+}
+
+TEST(EngineTests, NodeBudgetIsDeterministic){
+    auto engine = ChessEngine();
+    engine.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+    const auto first = engine.SearchNodes(MAX_SEARCH_PLY - 1, 20000);
+
+    engine.reset();
+    engine.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+    const auto second = engine.SearchNodes(MAX_SEARCH_PLY - 1, 20000);
+
+    // the budget cuts an iteration short, but only completed iterations are reported
+    EXPECT_GT(first.stats.depth, 0);
+    EXPECT_LT(first.stats.depth, MAX_SEARCH_PLY - 1);
+    EXPECT_EQ(first.bestMove, second.bestMove);
+    EXPECT_EQ(first.score, second.score);
+    EXPECT_EQ(first.stats.depth, second.stats.depth);
+}
+
+TEST(EngineTests, BenchSignatureIsDeterministic){
+    auto engine = ChessEngine();
+    const auto first = engine.bench(2);
+
+    // whatever the engine did before, bench starts every position from scratch
+    engine.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+    engine.Search(3);
+    const auto second = engine.bench(2);
+    const auto fresh = ChessEngine().bench(2);
+
+    EXPECT_GT(first.nodes, 0);
+    EXPECT_EQ(first.nodes, second.nodes);
+    EXPECT_EQ(first.nodes, fresh.nodes);
+    EXPECT_EQ(engine.boardManager()->getFullFen(), Fen::FULL_STARTING_FEN);
+}
+
+TEST(EngineTests, MoveTimeIsRespected){
+    auto engine = ChessEngine();
+    engine.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto result = engine.Search(SearchLimits{.movetime = 200});
+    const auto elapsed = std::chrono::steady_clock::now() - start;
+
+    EXPECT_GT(result.stats.depth, 0);
+    EXPECT_LT(elapsed, std::chrono::milliseconds(400));
+}
+
+TEST(EngineTests, FinishedSearchIsNotSearching){
+    auto engine = ChessEngine();
+    engine.parseUCI("position startpos");
+
+    testing::internal::CaptureStdout();
+    engine.parseUCI("go depth 1");
+    // nobody has joined the search thread yet, but the search itself is over
+    for (int i = 0; i < 200 && engine.isSearching(); i++) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    }
+    const auto output = testing::internal::GetCapturedStdout();
+
+    EXPECT_FALSE(engine.isSearching());
+    EXPECT_NE(output.find("bestmove "), std::string::npos);
+}
+
+TEST(EngineTests, PonderWaitsForPonderHit){
+    auto engine = ChessEngine();
+    engine.parseUCI("position " + Fen::FULL_KIWI_PETE_FEN);
+
+    testing::internal::CaptureStdout();
+    engine.parseUCI("go ponder movetime 100");
+
+    // the movetime doesn't apply until the opponent actually plays the move
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    EXPECT_TRUE(engine.isSearching());
+
+    engine.parseUCI("ponderhit");
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+    engine.parseUCI("isready");
+    const auto output = testing::internal::GetCapturedStdout();
+
+    const auto bestMove = output.find("bestmove ");
+    ASSERT_NE(bestMove, std::string::npos);
+    EXPECT_NE(output.find(" ponder ", bestMove), std::string::npos);
+    EXPECT_LT(bestMove, output.find("readyok"));
+}
+
+TEST(EngineTests, MultiPVReportsDistinctLines){
+    auto engine = ChessEngine();
+    engine.parseUCI("setoption name MultiPV value 3");
+    EXPECT_EQ(engine.getMultiPV(), 3);
+    engine.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+
+    testing::internal::CaptureStdout();
+    const auto result = engine.Search(SearchLimits{.depth = 3});
+    const auto output = testing::internal::GetCapturedStdout();
+
+    const auto& rootMoves = engine.getRootMoves();
+    EXPECT_EQ(result.bestMove, rootMoves[0].move);
+    for (int line = 0; line < 3; line++) {
+        EXPECT_FALSE(rootMoves[line].pv.empty());
+        EXPECT_EQ(rootMoves[line].pv.front(), rootMoves[line].move);
+        if (line > 0) { EXPECT_GE(rootMoves[line - 1].score, rootMoves[line].score); }
+    }
+    EXPECT_NE(output.find(" multipv 3 "), std::string::npos);
+
+    // the extra lines don't change the answer
+    auto singleLine = ChessEngine();
+    singleLine.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+    const auto single = singleLine.Search(SearchLimits{.depth = 3});
+    EXPECT_EQ(single.bestMove, result.bestMove);
+    EXPECT_EQ(single.score, result.score);
+}
+
+TEST(EngineTests, InfoLinesCarrySearchProgress){
+    auto engine = ChessEngine();
+    engine.setFullFen(Fen::FULL_KIWI_PETE_FEN);
+
+    testing::internal::CaptureStdout();
+    engine.Search(SearchLimits{.depth = 3});
+    const auto output = testing::internal::GetCapturedStdout();
+
+    const auto line = output.find("info depth 3 seldepth ");
+    ASSERT_NE(line, std::string::npos);
+    const auto lineEnd = output.find('\n', line);
+    const auto info = output.substr(line, lineEnd - line);
+    for (const auto* field: {" multipv 1 ", " score cp ", " nodes ", " nps ", " hashfull ", " time ", " pv "}) {
+        EXPECT_NE(info.find(field), std::string::npos) << field;
+    }
+}
+
+TEST(EngineTests, PositionCommandsExtendTheCurrentGame){
+    auto engine = ChessEngine();
+    engine.parseUCI("position startpos moves e2e4 e7e5");
+    engine.Search(3);
+    const auto storedEntries = engine.getTranspositionTable().populatedEntries();
+    ASSERT_GT(storedEntries, 0);
+
+    // the next move of the same game keeps what the last search learnt
+    engine.parseUCI("position startpos moves e2e4 e7e5 g1f3 b8c6");
+    EXPECT_EQ(engine.getTranspositionTable().populatedEntries(), storedEntries);
+    EXPECT_EQ(engine.boardManager()->getMoveHistory().size(), 4);
+
+    auto replayed = ChessEngine();
+    replayed.parseUCI("position startpos moves e2e4 e7e5 g1f3 b8c6");
+    EXPECT_EQ(engine.boardManager()->getZobristHash()->getHash(),
+              replayed.boardManager()->getZobristHash()->getHash());
+    EXPECT_EQ(engine.boardManager()->getFullFen(), replayed.boardManager()->getFullFen());
+
+    // a different game is replayed from scratch, but the table still only clears on ucinewgame
+    engine.parseUCI("position startpos moves d2d4");
+    EXPECT_EQ(engine.boardManager()->getMoveHistory().size(), 1);
+    EXPECT_GT(engine.getTranspositionTable().populatedEntries(), 0);
+
+    engine.parseUCI("ucinewgame");
+    EXPECT_EQ(engine.getTranspositionTable().populatedEntries(), 0);
+}
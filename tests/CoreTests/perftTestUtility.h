@@ -6,307 +6,212 @@
 #define PERFT_TEST_UTILITY_H
 
 #include <algorithm>
+#include <cstdint>
 #include <fstream>
-#include <ranges>
-#include "Engine/ChessEngine.h"
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "BoardManager/BoardManager.h"
+#include "Engine/MoveGenerator.h"
+#include "Engine/Perft.h"
 #include "Utility/Fen.h"
-#include "../../include/Engine/PerftResults.h"
-
-inline const std::string fileRoot = R"(C:\Users\jacks\source\repos\Chess\tests\output\)";
-inline const std::string divideCmd =
-        R"(C:\Users\jacks\source\repos\Chess\.venv\Scripts\python.exe C:\Users\jacks\source\repos\Chess\tests\Python\ExternalEnginePerftDivide.py)";
-
-inline const std::string moveCmd =
-        R"(C:\Users\jacks\source\repos\Chess\.venv\Scripts\python.exe C:\Users\jacks\source\repos\Chess\tests\Python\getMovesFromPosition.py)";
-
-inline std::unordered_map<int, std::string> insets = {{1, "1----"}, {2, "2---"}, {3, "3--"}, {4, "4-"}, {5, "5"}};
-
-inline std::vector<PerftResults> getDivideResults(const std::string& filename){
-    const std::string filePath = fileRoot + filename;
-    std::ifstream file(filePath);
-    std::vector<PerftResults> results;
-    std::string line;
-    while (std::getline(file, line)) {
-        std::string rootMoveUCI;
-        int nodes = 0;
-        int captures = 0;
-        int enPassant = 0;
-        int castling = 0;
-        int checks = 0;
-        int checkMate = 0;
-        int promotions = 0;
-        std::istringstream iss(line);
-        iss >> rootMoveUCI >> nodes >> captures >> enPassant >> castling >> checks >> checkMate >> promotions;
-        results.push_back(
-            PerftResults{nodes, captures, enPassant, castling, checks, checkMate, promotions, rootMoveUCI});
+#include "Utility/WorkStealingPool.h"
+
+/*
+ * Known divide counts, checked natively against the engine. The reference file is one entry per line:
+ *     <fen> ; <depth> ; <move> <nodes> <move> <nodes> ...
+ * after a "perft-reference <version>" header. Entries for the positions one move below a root entry
+ * let a failure be bisected down to the first move whose count differs.
+ */
+
+inline constexpr int PERFT_REFERENCE_VERSION = 1;
+
+#ifdef PERFT_REFERENCE_FILE
+inline const std::string perftReferenceFile = PERFT_REFERENCE_FILE;
+#else
+inline const std::string perftReferenceFile = "perft_reference.txt";
+#endif
+
+using DivideCounts = std::vector<std::pair<std::string, int64_t> >;
+
+struct PerftReference {
+    FenString fen;
+    int depth = 0;
+    DivideCounts divide;
+
+    int64_t total() const{
+        int64_t nodes = 0;
+        for (const auto& [move, count]: divide) { nodes += count; }
+        return nodes;
     }
-
-    return results;
-}
-
-inline std::vector<std::string> readMoves(const std::string& filename){
-    const std::string filePath = fileRoot + filename;
-    std::ifstream file(filePath);
-    std::vector<std::string> results;
-    std::string line;
-    while (std::getline(file, line)) {
-        std::string rootMoveUCI;
-        std::istringstream iss(line);
-        iss >> rootMoveUCI;
-        results.push_back(rootMoveUCI);
+};
+
+// where a reference check first went wrong - expected / actual of -1 means the move is missing on that side
+struct DivideMismatch {
+    std::vector<std::string> path;
+    FenString fen;
+    int depth = 0;
+    std::string move;
+    int64_t expected = 0;
+    int64_t actual = 0;
+
+    std::string toString() const{
+        std::string line;
+        for (const auto& step: path) { line += step + " "; }
+        return "after [ " + line + "] in " + fen + " at depth " + std::to_string(depth) + ": " + move + " expected "
+               + std::to_string(expected) + " got " + std::to_string(actual);
     }
+};
+
+// the clocks don't change what perft counts, so entries are matched on the first four fen fields
+inline std::string referenceKey(const FenString& fen, const int depth){
+    std::istringstream fields(fen);
+    std::string key;
+    std::string field;
+    for (int i = 0; i < 4 && fields >> field; i++) { key += field + " "; }
+    return key + std::to_string(depth);
+}
 
-    return results;
+inline std::string trim(const std::string& text){
+    const auto first = text.find_first_not_of(" \t\r");
+    if (first == std::string::npos) { return ""; }
+    const auto last = text.find_last_not_of(" \t\r");
+    return text.substr(first, last - first + 1);
 }
 
+inline std::vector<PerftReference> loadPerftReference(const std::string& path = perftReferenceFile){
+    std::ifstream file(path);
+    if (!file) { throw std::runtime_error("can't open perft reference " + path); }
 
-inline std::vector<std::pair<std::string, std::string> > readMovesResults(const std::string& filename){
-    const std::string filePath = fileRoot + filename;
-    std::ifstream file(filePath);
-    std::vector<std::pair<std::string, std::string> > results;
+    std::vector<PerftReference> references;
     std::string line;
+    bool sawVersion = false;
     while (std::getline(file, line)) {
-        std::string rootMoveUCI;
-        std::string result;
-        std::istringstream iss(line);
-        iss >> rootMoveUCI >> result;
-        results.push_back({rootMoveUCI, result});
-    }
-
-    return results;
-}
-
-inline bool generateExternalEngineMoves(const std::string& fen, const std::string& outputFile, const int depth = 1){
-    const std::string file = fileRoot + outputFile;
-
-    const std::string finalCommand =
-            divideCmd + " \"" + fen + "\" \"" + file + "\"" + " " + std::to_string(depth);
-
-    std::cout << "Executing command: " << finalCommand << std::endl;
-
-    [[maybe_unused]] const int result = system(finalCommand.c_str());
-
-    return result == 0;
-}
-
-inline bool runDivideTest(const std::string& fen, const std::string& outputFile){
-    const std::string file = fileRoot + outputFile;
-
-    const std::string finalCommand =
-            divideCmd + " \"" + fen + "\" \"" + file + "\"";
-
-    //std::cout << "Executing command: " << finalCommand << std::endl;
-
-    [[maybe_unused]] const int result = system(finalCommand.c_str());
-
-    return result == 0;
-}
-
-inline bool runGetMoveResults(const std::string& fen, const std::string& outputFile){
-    const std::string file = fileRoot + outputFile;
-    const std::string finalCommand =
-            moveCmd + " \"" + fen + "\" \"" + file + "\"";
-    //std::cout << "Executing command: " << finalCommand << std::endl;
-
-    [[maybe_unused]] const int result = system(finalCommand.c_str());
-
-    return result == 0;
-}
-
-
-inline void printMoveResults(const PerftResults& totalPy, const PerftResults& totalEngine,
-                             const std::string& printInset){
-    std::cout << printInset << "Type\tNodes\tCaptures\tCastles\tEP\tChecks\tCheckMates\tPromotions" << std::endl;
-
-    // Print Python results
-    std::cout << printInset << "Python\t"
-            << totalPy.nodes << "\t" << totalPy.captures << "\t"
-            << totalPy.castling << "\t" << totalPy.enPassant << "\t"
-            << totalPy.checks << "\t" << totalPy.checkMate << "\t"
-            << totalPy.promotions << std::endl;
-
-    // Print Engine results
-    std::cout << printInset << "Engine\t"
-            << totalEngine.nodes << "\t" << totalEngine.captures << "\t"
-            << totalEngine.castling << "\t" << totalEngine.enPassant << "\t"
-            << totalEngine.checks << "\t" << totalEngine.checkMate << "\t"
-            << totalEngine.promotions << std::endl;
-}
-
-inline void printHeadLineResults(const int depth, const std::vector<PerftResults>& pyMoves,
-                                 const std::vector<PerftResults>& engineResults, const std::string& printInset){
-    PerftResults totalPy;
-    for (const auto& move: pyMoves) { totalPy += move; }
-    PerftResults totalEngine;
-    for (const auto& move: engineResults) { totalEngine += move; }
-    printMoveResults(totalPy, totalEngine, printInset);
-}
-
-inline void getMovesInOurEngineNotExternal(bool& passing, std::vector<PerftResults>& externalEngineMoves,
-                                           const std::vector<PerftResults>& engineResults,
-                                           std::vector<PerftResults>& inOurEngineNotExternal){
-    // loop through each move in our engine result
-    for (const auto& ourMove: engineResults) {
-        auto correspondingMove = std::ranges::find_if(externalEngineMoves, [&](const auto& move) {
-            return move.fen == ourMove.fen;
-        });
-        if (correspondingMove == externalEngineMoves.end()) {
-            passing = false; // this move doesn't exist at all
-        }
-        if (ourMove != *correspondingMove) {
-            // this move exists but doesn't have the same results
-            passing = false;
-            std::cout << "Move: " << ourMove.fen << std::endl << "Our: " << ourMove.toString() << std::endl <<
-                    "Ext: " <<
-                    correspondingMove->toString() << std::endl;
-            inOurEngineNotExternal.push_back(ourMove);
+        line = trim(line);
+        if (line.empty() || line[0] == '#') { continue; }
+
+        if (!sawVersion) {
+            std::istringstream header(line);
+            std::string tag;
+            int version = 0;
+            header >> tag >> version;
+            if (tag != "perft-reference" || version != PERFT_REFERENCE_VERSION) {
+                throw std::runtime_error("unsupported perft reference header: " + line);
+            }
+            sawVersion = true;
+            continue;
         }
-    }
-}
 
-inline void getMovesInExternalEngineNotOurs(bool& passing, const std::vector<PerftResults>& externalEngineMoves,
-                                            std::vector<PerftResults>& engineResults,
-                                            std::vector<PerftResults>& inExternalEngineNotOurs){
-    for (const auto& externalEngineMove: externalEngineMoves) {
-        auto matching = std::ranges::find_if(engineResults, [&](const auto& move) {
-            return move.fen == externalEngineMove.fen;
-        });
-        if (matching == engineResults.end()) {
-            passing = false; // this move doesn't exist at all
-        }
-        if (externalEngineMove != *matching) {
-            // this move exists but doesn't have the same results
-            passing = false;
-            inExternalEngineNotOurs.push_back(externalEngineMove);
+        const auto firstSplit = line.find(';');
+        const auto secondSplit = line.find(';', firstSplit + 1);
+        if (firstSplit == std::string::npos || secondSplit == std::string::npos) {
+            throw std::runtime_error("malformed perft reference line: " + line);
         }
-    }
-}
 
-inline std::vector<PerftResults> getErrors(bool passing, std::vector<PerftResults> externalEngineMoves,
-                                           std::vector<PerftResults> engineResults,
-                                           std::vector<PerftResults>& inOurEngineNotExternal,
-                                           std::vector<PerftResults>& inExternalEngineNotOurs){
-    std::vector<PerftResults> erroringMoves;
-
-    getMovesInOurEngineNotExternal(passing, externalEngineMoves, engineResults, inOurEngineNotExternal);
-    getMovesInExternalEngineNotOurs(passing, externalEngineMoves, engineResults, inExternalEngineNotOurs);
-
-    // now zip them into one vector
-    erroringMoves.insert(erroringMoves.end(), inOurEngineNotExternal.begin(), inOurEngineNotExternal.end());
-
-    for (const auto& move: inExternalEngineNotOurs) {
-        if (std::ranges::any_of(erroringMoves, [&](const auto& errorMove) { return errorMove.fen != move.fen; })) {
-            erroringMoves.push_back(move);
-        }
+        PerftReference reference;
+        reference.fen = trim(line.substr(0, firstSplit));
+        reference.depth = std::stoi(line.substr(firstSplit + 1, secondSplit - firstSplit - 1));
+        std::istringstream counts(line.substr(secondSplit + 1));
+        std::string move;
+        int64_t nodes = 0;
+        while (counts >> move >> nodes) { reference.divide.emplace_back(move, nodes); }
+        references.push_back(std::move(reference));
     }
 
-    return erroringMoves;
+    if (!sawVersion) { throw std::runtime_error("perft reference " + path + " has no version header"); }
+    return references;
 }
 
-inline bool divideTest(const FenString& desiredFen, const std::string& outputFile, const int depth){
-    if (depth == 0)
-        return true;
-    bool passing = true;
-
-    // generate and read the external engine's moves
-    generateExternalEngineMoves(desiredFen, outputFile, depth);
-    auto externalEngineMoves = getDivideResults(outputFile);
-
-    // get our own starting moves
-    ChessEngine whiteEngine;
-    whiteEngine.setFullFen(desiredFen);
-    std::vector<PerftResults> engineResults = whiteEngine.runDivideTest(depth);
-
-    std::string printInset = insets[depth];
-    printHeadLineResults(depth, externalEngineMoves, engineResults, printInset);
-
-    std::vector<PerftResults> inOurEngineNotExternal;
-    std::vector<PerftResults> inExternalEngineNotOurs;
-    auto errorResults = getErrors(passing, externalEngineMoves, engineResults, inOurEngineNotExternal,
-                                  inExternalEngineNotOurs);
-
-    if (errorResults.empty()) { passing = true; } else { passing = false; }
-
-    // we can divide further
-    if (depth > 1) {
-        for (const auto& errorMove: errorResults) {
-            int iRank, iFile;
-            Fen::FenToRankAndFile(errorMove.fen, iRank, iFile);
-            auto pieceAtLocation = whiteEngine.boardManager()->getBitboards()->getPiece(iRank, iFile);
-            auto engineReadableErrorMove = createMove(pieceAtLocation.value(), errorMove.fen);
-            whiteEngine.boardManager()->tryMove(engineReadableErrorMove);
-            std::cout << "Move: " << errorMove.fen << " Dividing Further" << std::endl;
-
-            divideTest(whiteEngine.boardManager()->getFullFen(), outputFile, depth - 1);
-            whiteEngine.boardManager()->undoMove();
-
-            // temporary just do the first one
-            break;
-        }
+inline DivideCounts divideCounts(BoardManager& manager, const int depth){
+    DivideCounts counts;
+    for (auto& move: MoveGenerator::getMoves(manager)) {
+        manager.forceMove(move);
+        counts.emplace_back(move.toUCI(), Perft::count(manager, depth - 1));
+        manager.undoMove();
     }
+    return counts;
+}
 
-    // otherwise just get the moves
-    else if (!passing) {
-        runGetMoveResults(whiteEngine.boardManager()->getFullFen(), "movesOutput.txt");
-        auto externalMoveResults = readMovesResults("movesOutput.txt");
-        auto ourMoveResults = whiteEngine.generateMoveList();
+using ReferenceIndex = std::unordered_map<std::string, const PerftReference*>;
 
-        for (const auto& externalMoveResult: externalMoveResults) {
-            auto correspondingMove = std::ranges::find_if(ourMoveResults, [&](const auto ourMove) {
-                return ourMove.toUCI() == externalMoveResult.first;
-            });
+inline ReferenceIndex indexReferences(const std::vector<PerftReference>& references){
+    ReferenceIndex index;
+    for (const auto& reference: references) { index[referenceKey(reference.fen, reference.depth)] = &reference; }
+    return index;
+}
 
-            if (std::to_string(correspondingMove->resultBits) != externalMoveResult.second) {
-                passing = false;
-                std::cout << "Move: " << std::endl << externalMoveResult.first << " Oudr: " << correspondingMove->
-                        resultBits <<
-                        " External: " << externalMoveResult.second << std::endl;
+/*
+ * Compares the board's divide against the reference, in the reference's move order. At the first
+ * differing move it plays that move and carries on with the entry for the position below, if the
+ * file has one, so the mismatch reported is as deep as the reference data allows.
+ */
+inline std::optional<DivideMismatch> bisectDivide(BoardManager& manager, const PerftReference& reference,
+                                                  const ReferenceIndex& index, std::vector<std::string>& path){
+    const auto actual = divideCounts(manager, reference.depth);
+    const auto countFor = [](const DivideCounts& counts, const std::string& move) -> int64_t {
+        const auto found = std::ranges::find_if(counts, [&](const auto& entry){ return entry.first == move; });
+        return found == counts.end() ? -1 : found->second;
+    };
+
+    const auto mismatchHere = [&](const std::string& move, const int64_t expected, const int64_t actualNodes){
+        auto mismatchPath = path;
+        mismatchPath.push_back(move);
+        return DivideMismatch{
+                    .path = mismatchPath, .fen = manager.getFullFen(), .depth = reference.depth, .move = move,
+                    .expected = expected, .actual = actualNodes
+                };
+    };
+
+    for (const auto& [move, expected]: reference.divide) {
+        const int64_t actualNodes = countFor(actual, move);
+        if (actualNodes == expected) { continue; }
+
+        if (actualNodes >= 0 && reference.depth > 1) {
+            auto moves = MoveGenerator::getMoves(manager);
+            auto played = std::ranges::find_if(moves, [&](const Move& candidate){ return candidate.toUCI() == move; });
+            manager.forceMove(*played);
+            const auto child = index.find(referenceKey(manager.getFullFen(), reference.depth - 1));
+            std::optional<DivideMismatch> deeper;
+            if (child != index.end()) {
+                path.push_back(move);
+                deeper = bisectDivide(manager, *child->second, index, path);
+                path.pop_back();
             }
-
-            // temporary just do the first one
-            break;
+            manager.undoMove();
+            if (deeper) { return deeper; }
         }
+        return mismatchHere(move, expected, actualNodes);
     }
 
-    return passing;
-}
-
-inline bool compareMoveList(const FenString& startingFen, const Colours& colourtoMove, const std::string& outputFile){
-    auto engine = ChessEngine();
-    engine.setFullFen(startingFen);
-
-    auto ourMoves = engine.generateMoveList();
-
-    generateExternalEngineMoves(engine.boardManager()->getFullFen(), outputFile, 1);
-    auto pyMoves = readMoves(outputFile);
-
-    std::vector<std::string> ourMovesToTest;
-    for (auto& move: ourMoves) { ourMovesToTest.push_back(move.toUCI()); }
-
-    // in python, not in our engine
-    std::vector<std::string> inEngineNotInOurs;
-    for (const auto& move: pyMoves) {
-        if (!std::ranges::any_of(ourMovesToTest, [&](const auto& ourMove) { return ourMove == move; }))
-            inEngineNotInOurs.push_back(move);
-    }
-
-    std::vector<std::string> inOursNotInEngine;
-    for (const auto& move: ourMovesToTest) {
-        if (!std::ranges::any_of(pyMoves, [&](const auto& pyMove) { return pyMove == move; }))
-            inOursNotInEngine.push_back(move);
-    }
-
-    if (!inEngineNotInOurs.empty()) {
-        std::cout << "In external engine, not in ours:" << std::endl;
-        for (const auto& move: inEngineNotInOurs) { std::cout << move << std::endl; }
+    for (const auto& [move, actualNodes]: actual) {
+        if (countFor(reference.divide, move) < 0) { return mismatchHere(move, -1, actualNodes); }
     }
+    return std::nullopt;
+}
 
-    if (!inOursNotInEngine.empty()) {
-        std::cout << "In our engine, not in external engine:" << std::endl;
-        for (const auto& move: inOursNotInEngine) { std::cout << move << std::endl; }
+// every entry checked on its own worker - returns one slot per reference, empty when it matched
+inline std::vector<std::optional<DivideMismatch> > checkPerftReferences(
+    const std::vector<PerftReference>& references, const int threads = WorkStealingPool::defaultThreadCount()){
+    const auto index = indexReferences(references);
+    std::vector<std::optional<DivideMismatch> > results(references.size());
+
+    WorkStealingPool pool(threads);
+    std::vector<BoardManager> boards(pool.size());
+    for (size_t i = 0; i < references.size(); i++) {
+        pool.submit([&, i](const int worker){
+            auto& board = boards[worker];
+            board.setFullFen(references[i].fen);
+            std::vector<std::string> path;
+            results[i] = bisectDivide(board, references[i], index, path);
+        });
     }
-
-    return inEngineNotInOurs.empty() && inOursNotInEngine.empty();
+    pool.wait();
+    return results;
 }
 
-#endif //PERFT_TEST_UTILITY_H
\ No newline at end of file
+#endif //PERFT_TEST_UTILITY_H
@@ -7,6 +7,7 @@
 #include "BoardManager/BoardManager.h"
 #include "Engine/Piece.h"
 #include "Utility/math.h"
+#include "Utility/WorkStealingPool.h"
 
 TEST(Math, Utility){
     int i = 0;
@@ -55,4 +56,27 @@ TEST(Math, GetXBits){
 
     auto result = MathUtility::getXBits(testNumber, 4);
     EXPECT_EQ(result, 15);
-}
\ No newline at end of file
+}
+
+TEST(WorkStealingPool, RunsEveryTaskOnce){
+    WorkStealingPool pool(4);
+    std::vector<std::atomic<int> > runs(1000);
+    std::atomic<int> badWorker = 0;
+
+    for (size_t i = 0; i < runs.size(); i++) {
+        pool.submit([&, i](const int worker){
+            if (worker < 0 || worker >= pool.size()) { badWorker++; }
+            runs[i]++;
+        });
+    }
+    pool.wait();
+
+    EXPECT_EQ(badWorker, 0);
+    for (const auto& run: runs) { EXPECT_EQ(run, 1); }
+
+    // still usable after a wait
+    std::atomic<int> second = 0;
+    for (int i = 0; i < 10; i++) { pool.submit([&](int){ second++; }); }
+    pool.wait();
+    EXPECT_EQ(second, 10);
+}
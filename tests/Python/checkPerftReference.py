@@ -0,0 +1,59 @@
+import sys
+
+import chess
+
+
+# re-derives every divide in tests/CoreTests/perft_reference.txt with python-chess, so the file isn't only
+# checked against the engine that wrote it
+def perft(board, depth):
+    if depth == 0:
+        return 1
+
+    nodes = 0
+    for move in board.legal_moves:
+        board.push(move)
+        nodes += perft(board, depth - 1)
+        board.pop()
+    return nodes
+
+
+def divide(fen, depth):
+    board = chess.Board(fen)
+    result = {}
+    for move in board.legal_moves:
+        board.push(move)
+        result[move.uci()] = perft(board, depth - 1)
+        board.pop()
+    return result
+
+
+def check(path):
+    checked = 0
+    mismatches = 0
+    with open(path) as reference:
+        for line in reference:
+            line = line.strip()
+            if not line or line.startswith("#") or line.startswith("perft-reference"):
+                continue
+
+            fen, depth, moves = [field.strip() for field in line.split(";")]
+            tokens = moves.split()
+            # the engine writes white's promotions in upper case, python-chess always uses lower
+            expected = {tokens[i].lower(): int(tokens[i + 1]) for i in range(0, len(tokens), 2)}
+            actual = divide(fen, int(depth))
+
+            checked += 1
+            if actual != expected:
+                mismatches += 1
+                print("mismatch:", fen, "depth", depth)
+                for move in sorted(set(actual) | set(expected)):
+                    if actual.get(move) != expected.get(move):
+                        print("   ", move, "reference", expected.get(move), "python-chess", actual.get(move))
+
+    print(checked, "positions checked,", mismatches, "mismatches")
+    return mismatches == 0
+
+
+if __name__ == "__main__":
+    path = sys.argv[1] if len(sys.argv) > 1 else "tests/CoreTests/perft_reference.txt"
+    sys.exit(0 if check(path) else 1)